@@ -0,0 +1,401 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <benchmark/benchmark.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include "path.h"
+#include "logger.h"
+#include "config.h"
+#include "control.h"
+#include "fit.h"
+#include "display.h"
+#include "gamepad.h"
+#include "launcher.h"
+#include "library.h"
+#include "covers.h"
+#include "limiter.h"
+#include "metrics.h"
+#include "myapp.h"
+
+#include "fixtures.h"
+
+// ---------------------------------------------------------------------------
+
+// default config with extra resolutions and apps appended
+static std::string make_config(int entries)
+{
+    std::string content = default_config;
+    for (int i = 0; i < entries; i++) {
+        content += "\n[[resolutions]]\nname = \"Preset " + std::to_string(i) + "\"\nfreq = 60\nscale = 1.5\n";
+        content += "width = " + std::to_string(1280 + i * 16) + "\nheight = " + std::to_string(720 + i * 9) + "\n";
+        content += "\n[[apps]]\nname = \"App " + std::to_string(i) + "\"\nelevated = false\n";
+        content += "commands = \"\"\"\nstart \"\" \"app" + std::to_string(i) + ".exe\"\n\"\"\"\n";
+    }
+    return content;
+}
+
+// ---------------------------------------------------------------------------
+
+static void BM_ConfigParse(benchmark::State& state)
+{
+    const std::string content = make_config(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Config config{};
+        benchmark::DoNotOptimize(parse_config(content, config));
+    }
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_ConfigParse)->Arg(0)->Arg(16)->Arg(256);
+
+static void BM_DisplayModeMerge(benchmark::State& state)
+{
+    const auto modes = make_modes(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<DisplaySettings> display_settings{};
+        for (const auto& mode : modes)
+            merge_display_settings(display_settings, mode);
+        sort_display_settings(display_settings);
+        benchmark::DoNotOptimize(display_settings.data());
+    }
+    state.SetItemsProcessed(state.iterations() * modes.size());
+}
+BENCHMARK(BM_DisplayModeMerge)->Arg(8)->Arg(32)->Arg(128);
+
+static void BM_DisplayModeLookup(benchmark::State& state)
+{
+    std::vector<DisplaySettings> display_settings{};
+    for (const auto& mode : make_modes(static_cast<int>(state.range(0))))
+        merge_display_settings(display_settings, mode);
+    sort_display_settings(display_settings);
+
+    size_t index = 0;
+    for (auto _ : state) {
+        const auto& target = display_settings[index++ % display_settings.size()];
+        benchmark::DoNotOptimize(find_display_settings(display_settings, target.width, target.height));
+    }
+}
+BENCHMARK(BM_DisplayModeLookup)->Arg(8)->Arg(32)->Arg(128);
+
+static void BM_ModeFit(benchmark::State& state)
+{
+    const bool cached = state.range(0) != 0;
+
+    ModeFitter fitter{};
+    fitter.reset(monitor_4k_144hz);
+    for (auto _ : state) {
+        if (!cached)
+            fitter.cache.clear();
+        for (const auto& c : fit_cases)
+            benchmark::DoNotOptimize(fitter.best(c.width, c.height, c.fps));
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(fit_cases));
+}
+BENCHMARK(BM_ModeFit)->ArgNames({"cached"})->Arg(0)->Arg(1);
+
+static void BM_RingBufferSink(benchmark::State& state)
+{
+    auto sink   = std::make_shared<RingBufferSink>(static_cast<size_t>(state.range(0)));
+    auto logger = std::make_shared<spdlog::logger>("bench", sink);
+
+    int i = 0;
+    for (auto _ : state) {
+        logger->info("Display resolution changed to {}x{}.", 1920, 1080 + (i++ & 0xFF));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RingBufferSink)->Arg(512);
+
+// trace is below SPDLOG_ACTIVE_LEVEL in release builds, info formats into a null sink
+static void BM_LoggerLevel(benchmark::State& state)
+{
+    int i = 0;
+    for (auto _ : state) {
+        if (state.range(0) == 0)
+            Logger::trace("Uploaded cover {} ({}x{})", "cover.png", 600, 900 + (i++ & 0xFF));
+        else
+            Logger::info("Uploaded cover {} ({}x{})", "cover.png", 600, 900 + (i++ & 0xFF));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLevel)->ArgNames({"info"})->Arg(0)->Arg(1);
+
+// one counter per thread, padded counters do not slow each other down
+static void BM_MetricsCounter(benchmark::State& state)
+{
+    static const char* const names[] = {"bench_counter_0", "bench_counter_1", "bench_counter_2", "bench_counter_3"};
+    Counter& counter = metrics().counter(names[state.thread_index() % 4], "Benchmark counter");
+
+    for (auto _ : state)
+        counter.add();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricsCounter)->Threads(1)->Threads(4);
+
+static void BM_MetricsExport(benchmark::State& state)
+{
+    Histogram& histogram = metrics().histogram("bench_seconds", "Benchmark histogram", {0.001, 0.01, 0.1, 1.0});
+    for (int i = 0; i < 1000; i++)
+        histogram.observe(i / 1000.0);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(metrics().text());
+}
+BENCHMARK(BM_MetricsExport);
+
+// how late the limiter releases frames past their deadline
+static void BM_FrameLimiter(benchmark::State& state)
+{
+    FrameLimiter limiter{};
+    limiter.start(static_cast<int>(state.range(0)));
+
+    double late = 0.0;
+    for (auto _ : state) {
+        limiter.wait();
+        late += std::chrono::duration<double, std::micro>(FrameLimiter::Clock::now() - limiter.deadline).count();
+    }
+    state.counters["late_us"] = late / state.iterations();
+    state.counters["missed"]  = static_cast<double>(limiter.missed);
+}
+BENCHMARK(BM_FrameLimiter)->Arg(60)->Arg(240)->Iterations(120)->UseRealTime();
+
+static void BM_DisplayLabel(benchmark::State& state)
+{
+    std::vector<DisplaySettings> display_settings{};
+    for (const auto& mode : make_modes(32))
+        merge_display_settings(display_settings, mode);
+    display_settings.front().name = "4K";
+
+    FrameArena arena{};
+    for (auto _ : state) {
+        arena.reset();
+        for (const auto& settings : display_settings)
+            benchmark::DoNotOptimize(display_label(arena, settings));
+    }
+    state.SetItemsProcessed(state.iterations() * display_settings.size());
+}
+BENCHMARK(BM_DisplayLabel);
+
+static void BM_LauncherLabel(benchmark::State& state)
+{
+    AppLauncher launcher{"Steam Big Picture", "Steam_Big_Picture.bat", false, "start steam://open/bigpicture"};
+    FrameArena  arena{};
+    for (auto _ : state) {
+        arena.reset();
+        benchmark::DoNotOptimize(launcher_label(arena, launcher));
+    }
+}
+BENCHMARK(BM_LauncherLabel);
+
+static void BM_GamepadMapping(benchmark::State& state)
+{
+    GamepadProfiles profiles{};
+    profiles.overrides["03000000de280000ff11000001000000"] = GamepadProfile{};
+
+    float axes[GAMEPAD_AXIS_COUNT] = {0.3f, -0.7f, 0.05f, 0.9f, -1.0f, 0.4f};
+    for (auto _ : state) {
+        const auto& profile = profiles.find("03000000de280000ff11000001000000");
+        benchmark::DoNotOptimize(apply_gamepad_profile(profile, axes));
+        axes[0] = -axes[0];
+    }
+}
+BENCHMARK(BM_GamepadMapping);
+
+// pipelined requests over the control pipe, `depth` in flight per round trip
+static void BM_ControlLoopback(benchmark::State& state)
+{
+    const std::string name = CONTROL_PIPE_NAME "-Bench";
+
+    ControlServer server{};
+    server.start([](std::string_view request) {
+        ControlWriter writer{};
+        writer.u8(static_cast<uint8_t>(ControlStatus::Ok));
+        writer.i32(1920);
+        writer.i32(1080);
+        writer.i32(60);
+        writer.f32(1.5f);
+        return writer.buffer;
+    }, name);
+
+    ControlClient client{};
+    if (!client.connect(name)) {
+        state.SkipWithError("failed to connect to the control pipe");
+        return;
+    }
+
+    ControlWriter request{};
+    request.u8(static_cast<uint8_t>(ControlCommand::Status));
+
+    std::string response;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); i++)
+            client.send(request.buffer);
+        for (int64_t i = 0; i < state.range(0); i++)
+            client.receive(response);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    client.disconnect();
+    server.stop();
+}
+BENCHMARK(BM_ControlLoopback)->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
+
+// one Steam library folder with 256 installed games, scanned cold and from the mtime cache
+static void BM_LibraryScan(benchmark::State& state)
+{
+    auto steamapps = std::filesystem::temp_directory_path() / "moonlight-launcher-bench-steamapps";
+    std::filesystem::create_directories(steamapps);
+    for (int i = 0; i < 256; i++) {
+        std::ofstream(steamapps / ("appmanifest_" + std::to_string(1000 + i) + ".acf"))
+            << "\"AppState\"\n{\n\t\"appid\"\t\t\"" << 1000 + i << "\"\n\t\"Universe\"\t\t\"1\"\n"
+            << "\t\"name\"\t\t\"Game " << i << "\"\n\t\"StateFlags\"\t\t\"4\"\n}\n";
+    }
+
+    std::vector<LibraryDirectory> cache{};
+    if (state.range(0) != 0)
+        cache.push_back(scan_library_directory("steam", steamapps.string(), {}));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scan_library_directory("steam", steamapps.string(), cache));
+    }
+    state.SetItemsProcessed(state.iterations() * 256);
+
+    std::filesystem::remove_all(steamapps);
+}
+BENCHMARK(BM_LibraryScan)->ArgNames({"cached"})->Arg(0)->Arg(1);
+
+// spawn of a launcher script with scheduling options applied while suspended
+static void BM_SpawnAffinity(benchmark::State& state)
+{
+    auto script = std::filesystem::temp_directory_path() / "moonlight-launcher-bench.bat";
+    std::ofstream(script) << "@ping -n 2 127.0.0.1 >nul\n";
+
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask);
+
+    // lowest core, the next one reserved
+    ProcessOptions options{};
+    options.affinity       = system_mask & (~system_mask + 1);
+    options.reserved       = (system_mask & ~options.affinity) & (~(system_mask & ~options.affinity) + 1);
+    options.affinity      |= options.reserved;
+    options.priority_class = BELOW_NORMAL_PRIORITY_CLASS;
+    options.io_priority    = 1;
+
+    for (auto _ : state) {
+        HANDLE process = spawn_process(script.string(), false, options);
+        if (!process) {
+            state.SkipWithError("failed to spawn the script");
+            break;
+        }
+
+        TerminateProcess(process, 0);
+        WaitForSingleObject(process, INFINITE);
+        CloseHandle(process);
+    }
+
+    std::filesystem::remove(script);
+}
+BENCHMARK(BM_SpawnAffinity)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// scrolling a page of covers at a time, frames until the page is shown, within the texture budget
+static void BM_CoverCache(benchmark::State& state)
+{
+    constexpr int count = 64, page = 8, width = 60, height = 90;
+
+    auto folder = std::filesystem::temp_directory_path() / "moonlight-launcher-bench-covers";
+    std::filesystem::create_directories(folder);
+
+    std::vector<std::string> paths{};
+    for (int i = 0; i < count; i++) {
+        paths.push_back((folder / ("cover" + std::to_string(i) + ".bmp")).string());
+        write_bmp(paths.back(), width, height, 0x102030u * (i + 1));
+    }
+
+    // room for two pages, the rest is evicted as the grid scrolls
+    const size_t page_bytes = size_t(page) * width * height * sizeof(uint32_t);
+    const size_t budget     = page_bytes * 2;
+
+    SoftwareRenderer renderer{};
+    CoverCache       covers{};
+    covers.start(&renderer, budget, 2, nullptr);
+
+    int first = 0;
+    for (auto _ : state) {
+        int shown = 0;
+        while (shown < page && covers.failures == 0) {
+            covers.update(std::chrono::milliseconds(2));
+            shown = 0;
+            for (int i = first; i < first + page; i++)
+                shown += covers.request(paths[i % count], width, height).texture != nullptr;
+            if (shown < page)
+                std::this_thread::yield();
+        }
+
+        if (covers.failures > 0) {
+            state.SkipWithError("failed to decode a cover");
+            break;
+        }
+        first = (first + page) % count;
+    }
+    state.SetItemsProcessed(state.iterations() * page);
+    state.counters["evictions"] = static_cast<double>(covers.evictions);
+
+    covers.stop();
+    std::filesystem::remove_all(folder);
+}
+BENCHMARK(BM_CoverCache)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// one MyApp frame on the headless backends, per tab, with and without rasterizing
+static void BM_Frame(benchmark::State& state)
+{
+    MyApp app;
+    app.width          = 1280;
+    app.height         = 720;
+    app.tab_index      = static_cast<int>(state.range(0));
+    app.platform       = std::make_unique<NullPlatform>(0);
+    app.renderer       = std::make_unique<SoftwareRenderer>();
+    app.redraw.enabled = state.range(1) == 0;
+    app.logs           = std::make_shared<RingBufferSink>(512);
+
+    Config config{};
+    parse_config(default_config, config);
+    app.preset_display_settings = config.display_settings;
+    app.application_launchers   = config.application_launchers;
+    for (const auto& mode : make_modes(32))
+        merge_display_settings(app.supported_display_settings, mode);
+
+    app.setup();
+
+    // first frames size ImGui's buffers and the arena
+    for (int i = 0; i < 8; i++)
+        app.frame();
+
+    AllocationStats allocations{};
+    for (auto _ : state) {
+        app.frame();
+        allocations.count += app.frame_allocations.count;
+        allocations.bytes += app.frame_allocations.bytes;
+    }
+    app.cleanup();
+
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocations.count), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Frame)->ArgsProduct({{0, 1, 2, 3, 4}, {0, 1}})->ArgNames({"tab", "raster"})->Unit(benchmark::kMicrosecond);
+
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    // keep log output out of the measurements
+    Logger::set_logger(std::make_shared<spdlog::logger>(APP_NAME, std::make_shared<spdlog::sinks::null_sink_mt>()));
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,8 +1,10 @@
 # export compilation database
 set(CMAKE_EXPORT_COMPILE_COMMANDS ON)
 
-# enable C++ 17
-set(CMAKE_CXX_STANDARD 17)
+# C++ 20 is required, not only preferred: consteval format strings (logger.h),
+# std::atomic<double>::fetch_add (metrics.cpp) and std::popcount from <bit> (application.cpp)
+set(CMAKE_CXX_STANDARD 20)
+set(CMAKE_CXX_STANDARD_REQUIRED ON)
 
 # For Visual Studio
 set_property(GLOBAL PROPERTY USE_FOLDERS ON)
@@ -0,0 +1,27 @@
+include(FetchContent)
+
+# define external project
+FetchContent_Declare(
+  benchmark
+  GIT_REPOSITORY https://github.com/google/benchmark.git
+  GIT_TAG        v1.8.3
+)
+
+# get properties
+FetchContent_GetProperties(benchmark)
+
+# build benchmark when needed
+set(BENCHMARK_ENABLE_TESTING       OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS   OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL       OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_INSTALL_DOCS         OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_WERROR        OFF CACHE BOOL "" FORCE)
+if(NOT TARGET benchmark)
+  FetchContent_MakeAvailable(benchmark)
+endif()
+
+# mark benchmark as found
+set(Benchmark_FOUND TRUE)
+
+# move to different folder
+set_target_properties(benchmark PROPERTIES FOLDER "Vendors")
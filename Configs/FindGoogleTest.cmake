@@ -0,0 +1,25 @@
+include(FetchContent)
+
+# define external project
+FetchContent_Declare(
+  googletest
+  GIT_REPOSITORY https://github.com/google/googletest.git
+  GIT_TAG        v1.14.0
+)
+
+# get properties
+FetchContent_GetProperties(googletest)
+
+# build googletest when needed, with the same CRT as the launcher
+set(gtest_force_shared_crt ON  CACHE BOOL "" FORCE)
+set(BUILD_GMOCK            OFF CACHE BOOL "" FORCE)
+set(INSTALL_GTEST          OFF CACHE BOOL "" FORCE)
+if(NOT TARGET gtest)
+  FetchContent_MakeAvailable(googletest)
+endif()
+
+# mark googletest as found
+set(GoogleTest_FOUND TRUE)
+
+# move to different folder
+set_target_properties(gtest gtest_main PROPERTIES FOLDER "Vendors")
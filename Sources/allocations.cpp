@@ -0,0 +1,76 @@
+#include <new>
+#include <cstdlib>
+#include <malloc.h>
+
+#include "allocations.h"
+
+// replaces the global operator new and delete for the whole program,
+// counters are per thread so counting costs no more than two additions
+static thread_local AllocationStats allocations{};
+
+AllocationStats thread_allocations()
+{
+    return allocations;
+}
+
+static void* allocate(std::size_t size)
+{
+    allocations.count++;
+    allocations.bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+static void* allocate(std::size_t size, std::align_val_t align)
+{
+    allocations.count++;
+    allocations.bytes += size;
+    return _aligned_malloc(size ? size : 1, static_cast<std::size_t>(align));
+}
+
+// clang-format off
+void* operator new(std::size_t size)
+{
+    if (void* ptr = allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* ptr = allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    if (void* ptr = allocate(size, align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    if (void* ptr = allocate(size, align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept                           { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept                         { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept   { return allocate(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return allocate(size, align); }
+
+void operator delete(void* ptr) noexcept                                            { std::free(ptr); }
+void operator delete[](void* ptr) noexcept                                          { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept                               { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept                             { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept                     { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept                   { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept                          { _aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept                        { _aligned_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept             { _aligned_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept           { _aligned_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept   { _aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(ptr); }
+// clang-format on
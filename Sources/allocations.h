@@ -0,0 +1,22 @@
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+#include <cstdint>
+
+// Heap allocations made through operator new.
+struct AllocationStats
+{
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+
+    AllocationStats operator-(const AllocationStats& other) const
+    {
+        return AllocationStats{count - other.count, bytes - other.bytes};
+    }
+};
+
+// running totals of the calling thread, ImGui's own buffers go through
+// its allocator and are not included
+AllocationStats thread_allocations();
+
+#endif // ALLOCATIONS_H
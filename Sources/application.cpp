@@ -1,80 +1,128 @@
+#include <bit>
+#include <chrono>
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 #include <cmrc/cmrc.hpp>
 #include <imgui.h>
-#include <imgui_impl_glfw.h>
-#include <imgui_impl_opengl3.h>
 
 #include "font.h"
 #include "logger.h"
+#include "metrics.h"
+#include "timeline.h"
 #include "application.h"
 
 // Register the resource library
 CMRC_DECLARE(fonts);
 
-#define MAP_BUTTON(KEY_NO, BUTTON_NO, _UNUSED)                   \
-    do {                                                         \
-        io.AddKeyEvent(KEY_NO, gamepad.buttons[BUTTON_NO] != 0); \
-    } while (0);
-
-#define MAP_ANALOG(KEY_NO, AXIS_NO, _UNUSED, V0, V1)                        \
-    do {                                                                    \
-        float v = gamepad.axes[AXIS_NO];                                    \
-        v       = (v - V0) / (V1 - V0);                                     \
-        io.AddKeyAnalogEvent(KEY_NO, v > 0.10f, std::clamp(v, 0.0f, 1.0f)); \
-    } while (0);
+// clang-format off
+static Counter&   frames_submitted = metrics().counter("launcher_frames_submitted", "Frames rendered and presented");
+static Counter&   frames_skipped   = metrics().counter("launcher_frames_skipped", "Frames identical to the last one, not submitted");
+static Counter&   gamepad_connects = metrics().counter("launcher_gamepad_connects", "Gamepads connected while the UI was shown");
+static Gauge&     gamepads         = metrics().gauge("launcher_gamepads", "Gamepads connected");
+static Gauge&     ui_allocations   = metrics().gauge("launcher_ui_allocations", "Heap allocations of the last frame's UI pass");
+static Histogram& frame_seconds    = metrics().histogram("launcher_frame_seconds", "Frame time up to the swap, without waiting for events",
+    {0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.066, 0.133, 0.25, 0.5, 1.0});
+// clang-format on
 
 // ---------------------------------------------------------------------------
 
-static void on_move(GLFWwindow* window, double xpos, double ypos)
-{
-    // restore access to cursor on mouse move
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-}
-
-static void on_key(GLFWwindow* window, int key, int scancode, int action, int mods)
-{
-    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, GLFW_TRUE);
-}
-
-static void on_scale(GLFWwindow* window, float xscale, float yscale)
+void Application::run()
 {
-    ImGuiIO& io = ImGui::GetIO();
-
-    io.DisplayFramebufferScale = ImVec2(xscale, yscale);
+    setup();
+    while (!platform->should_close())
+        frame();
+    cleanup();
 }
 
-static void on_error(int error, const char* description)
+void Application::frame()
 {
-    Logger::error("[GLFW] Error: {}\n", description);
-}
-
-// ---------------------------------------------------------------------------
+    // startup ends with the first frame, only traced while the timeline records
+    bool tracing = timeline().enabled();
+    auto begin   = Timeline::Clock::now();
+
+    // strings of the last frame are gone, its draw data has been submitted
+    arena.reset();
+
+    profiler.begin_frame();
+
+    {
+        // pace the frame, then sample input as late as possible before NewFrame
+        auto scope = profiler.scope(FramePhase::Poll);
+        if (presented) {
+            limiter.wait();
+            platform->wait(0.0);
+        } else {
+            // no swap to block on vsync, wait for events for a refresh period instead
+            platform->wait(1.0 / refresh_rate);
+            limiter.restart();
+        }
+    }
+    auto work = Timeline::Clock::now();
 
-void Application::run()
-{
-    setup();
-    while (!glfwWindowShouldClose(window)) {
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
+    int width, height;
+    platform->framebuffer_size(width, height);
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
+    {
+        auto scope = profiler.scope(FramePhase::NewFrame);
+        renderer->new_frame();
+        platform->new_frame();
+        tracer.before_new_frame();
         ImGui::NewFrame();
+        tracer.after_new_frame();
+    }
+
+    // the UI pass should not touch the heap once it reached steady state
+    AllocationStats allocations = thread_allocations();
+    {
+        auto scope = profiler.scope(FramePhase::Gamepad);
         gamepad();
+    }
+    {
+        auto scope = profiler.scope(FramePhase::Tick);
         tick();
+    }
+    profiler.render();
+    {
+        auto scope = profiler.scope(FramePhase::Render);
         ImGui::Render();
+    }
+    frame_allocations = thread_allocations() - allocations;
+    ui_allocations.set(static_cast<int64_t>(frame_allocations.count));
+
+    // skip clear/submit/swap when the frame looks exactly like the last one
+    bool submit = redraw.update(ImGui::GetDrawData(), width, height);
+    if (submit) {
+        {
+            auto scope = profiler.scope(FramePhase::Clear);
+            renderer->clear(width, height, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
+        }
+        {
+            auto scope = profiler.scope(FramePhase::Submit);
+            renderer->render(ImGui::GetDrawData());
+        }
+        {
+            // latency is measured up to the swap returning, which blocks with vsync
+            auto scope = profiler.scope(FramePhase::Swap);
+            platform->present();
+            if (gpu_finish)
+                renderer->finish();
+            latency.submit();
+        }
+        frames_submitted.add();
+    } else {
+        latency.skip();
+        frames_skipped.add();
+    }
+    frame_seconds.observe(std::chrono::duration<double>(Timeline::Clock::now() - work).count());
+    presented = submit;
 
-        glViewport(0, 0, width, height);
-        glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        glfwSwapBuffers(window);
+    profiler.end_frame();
 
-        glfwPollEvents();
+    if (tracing) {
+        timeline().record("first frame", begin, Timeline::Clock::now());
+        timeline().save();
     }
-    cleanup();
 }
 
 void Application::tick()
@@ -108,44 +156,27 @@ void Application::theme()
 
 void Application::setup()
 {
-    if (!glfwInit()) {
-        Logger::error("[GLFW] failed to initialize GLFW!");
-        exit(1);
-    }
+    auto trace = timeline().scope("Application::setup");
+
+    // desktop window with OpenGL unless a backend was chosen beforehand
+    if (!platform)
+        platform = std::make_unique<GlfwPlatform>();
+    if (!renderer)
+        renderer = std::make_unique<OpenGLRenderer>();
 
-    // create window
-    glfwWindowHint(GLFW_DECORATED, decorated ? GLFW_TRUE : GLFW_FALSE);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
-
-    // callbacks
-    glfwSetWindowUserPointer(window, this);
-    glfwSetErrorCallback(on_error);
-    glfwSetKeyCallback(window, on_key);
-    glfwSetCursorPosCallback(window, on_move);
-    glfwSetWindowContentScaleCallback(window, on_scale);
-
-    // OpenGL context
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
-
-    // initialize OpenGL3
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    if (!ImGui_ImplOpenGL3_Init("#version 150")) {
-        Logger::error("[ImGui] Failed to initialize OpenGL3!");
-        glfwTerminate();
-        exit(-1);
-    }
 
-    // scale
-    glfwGetWindowContentScale(window, &xscale, &yscale);
+    // window creation, font baking and the tasks of derived apps overlap
+    TaskGraph  graph{};
+    SetupTasks tasks{};
+    setup_tasks(graph, tasks);
 
-    // fonts
-    fonts();
+    // a failed backend exits only once the workers are joined
+    if (int code = graph.run(2)) {
+        ImGui::DestroyContext();
+        exit(code);
+    }
 
     // UI theme
     theme();
@@ -156,80 +187,129 @@ void Application::setup()
     io.LogFilename = nullptr;
 }
 
+void Application::setup_tasks(TaskGraph& graph, SetupTasks& tasks)
+{
+    // window and platform backend
+    tasks.window = graph.add("window", [this, &graph]() {
+        if (!platform->init(*this))
+            graph.fail(1);
+    }, {}, TaskGraph::Main);
+
+    // renderer backend and frame profiler (GL timer queries)
+    tasks.renderer = graph.add("renderer", [this, &graph]() {
+        if (!renderer->init()) {
+            platform->shutdown();
+            graph.fail(-1);
+            return;
+        }
+        profiler.init();
+    }, {tasks.window}, TaskGraph::Main);
+
+    // read again once the tasks it depends on are done, e.g. a display mode change;
+    // after the renderer so that no other task touches ImGui while the atlas is baked
+    tasks.scale = graph.add("content scale", [this]() {
+        platform->content_scale(xscale, yscale);
+    }, {tasks.window, tasks.renderer}, TaskGraph::Main);
+
+    // fonts
+    tasks.fonts = graph.add("fonts", [this]() {
+        fonts();
+    }, {tasks.scale});
+
+    tasks.upload = graph.add("font upload", [this]() {
+        renderer->create_fonts_texture();
+    }, {tasks.renderer, tasks.fonts}, TaskGraph::Main);
+
+    // swap interval needs the context, derived apps add the tasks that choose the mode
+    tasks.present = graph.add("present mode", [this]() {
+        configure_present();
+    }, {tasks.window}, TaskGraph::Main);
+}
+
+void Application::configure_present()
+{
+    refresh_rate = platform->refresh_rate();
+
+    // headless frames are not paced
+    bool vsync = present_mode == VSync;
+    if (!platform->swap_interval(vsync ? 1 : 0))
+        return;
+
+    int rate = frame_rate > 0 ? frame_rate : refresh_rate;
+    if (vsync) {
+        limiter.stop();
+        latency.mode = "vsync (swap interval 1)";
+    } else {
+        limiter.start(rate);
+        latency.mode = "limiter at " + std::to_string(rate) + " fps (swap interval 0)";
+    }
+    if (gpu_finish)
+        latency.mode += ", glFinish";
+
+    Logger::info("Present mode: {}", latency.mode);
+}
+
 void Application::cleanup()
 {
+    // profiler cleanup
+    profiler.shutdown();
+
+    // backend cleanup
+    renderer->shutdown();
+    platform->shutdown();
+
     // imgui cleanup
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
-
-    // clean up
-    glfwDestroyWindow(window);
-    glfwTerminate();
 }
 
 void Application::gamepad()
 {
-    auto update_joystick_events = [](int joystick) {
-        ImGuiIO& io = ImGui::GetIO();
-
-        GLFWgamepadstate gamepad;
+    ImGuiIO& io = ImGui::GetIO();
 
-        if (!glfwGetGamepadState(joystick, &gamepad))
-            return;
+    bool     connected = false;
+    uint32_t present   = 0; // joysticks with a gamepad mapping
 
-        if (!glfwJoystickPresent(joystick)) {
-            for (int i = 0; i < ImGuiNavInput_COUNT; ++i)
-                io.NavInputs[i] = 0.0f;
-            return;
+    // query gamepad support
+    for (int joystick = GLFW_JOYSTICK_1; joystick <= GLFW_JOYSTICK_LAST; joystick++) {
+        GLFWgamepadstate state;
+        if (!platform->gamepad_state(joystick, state))
+            continue;
+
+        // gamepad events are queued after NewFrame(), so they show up one frame later
+        if (std::memcmp(&state, &gamepad_states[joystick], sizeof(state)) != 0) {
+            gamepad_states[joystick] = state;
+            latency.input(LatencyTracker::Gamepad, 1);
         }
 
-        int count;
-
-        // Get the joystick axes
-        const float* axes = glfwGetJoystickAxes(joystick, &count);
-        if (axes) {
-            // clang-format off
-            MAP_ANALOG(ImGuiKey_GamepadLStickLeft,  GLFW_GAMEPAD_AXIS_LEFT_X,  0, -0.25f, -1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadLStickRight, GLFW_GAMEPAD_AXIS_LEFT_X,  0, +0.25f, +1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadLStickUp,    GLFW_GAMEPAD_AXIS_LEFT_Y,  1, -0.25f, -1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadLStickDown,  GLFW_GAMEPAD_AXIS_LEFT_Y,  1, +0.25f, +1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadRStickLeft,  GLFW_GAMEPAD_AXIS_RIGHT_X, 2, -0.25f, -1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadRStickRight, GLFW_GAMEPAD_AXIS_RIGHT_X, 2, +0.25f, +1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadRStickUp,    GLFW_GAMEPAD_AXIS_RIGHT_Y, 3, -0.25f, -1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadRStickDown,  GLFW_GAMEPAD_AXIS_RIGHT_Y, 3, +0.25f, +1.0f);
-            // clang-format on
-        }
+        const auto& profile = gamepad_profiles.find(platform->gamepad_guid(joystick));
+        const auto  values  = apply_gamepad_profile(profile, state.axes);
+
+        for (const auto& mapping : profile.buttons)
+            io.AddKeyEvent(mapping.key, state.buttons[mapping.button] == GLFW_PRESS);
 
-        // Get the joystick buttons
-        const unsigned char* buttons = glfwGetJoystickButtons(joystick, &count);
-        if (buttons) {
-            io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
-            // clang-format off
-            MAP_BUTTON(ImGuiKey_GamepadStart,     GLFW_GAMEPAD_BUTTON_START,        7);
-            MAP_BUTTON(ImGuiKey_GamepadBack,      GLFW_GAMEPAD_BUTTON_BACK,         6);
-            MAP_BUTTON(ImGuiKey_GamepadFaceLeft,  GLFW_GAMEPAD_BUTTON_X,            2);  // Xbox X, PS Square
-            MAP_BUTTON(ImGuiKey_GamepadFaceRight, GLFW_GAMEPAD_BUTTON_B,            1);  // Xbox B, PS Circle
-            MAP_BUTTON(ImGuiKey_GamepadFaceUp,    GLFW_GAMEPAD_BUTTON_Y,            3);  // Xbox Y, PS Triangle
-            MAP_BUTTON(ImGuiKey_GamepadFaceDown,  GLFW_GAMEPAD_BUTTON_A,            0);  // Xbox A, PS Cross
-            MAP_BUTTON(ImGuiKey_GamepadDpadLeft,  GLFW_GAMEPAD_BUTTON_DPAD_LEFT,    13);
-            MAP_BUTTON(ImGuiKey_GamepadDpadRight, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT,   11);
-            MAP_BUTTON(ImGuiKey_GamepadDpadUp,    GLFW_GAMEPAD_BUTTON_DPAD_UP,      10);
-            MAP_BUTTON(ImGuiKey_GamepadDpadDown,  GLFW_GAMEPAD_BUTTON_DPAD_DOWN,    12);
-            MAP_BUTTON(ImGuiKey_GamepadL1,        GLFW_GAMEPAD_BUTTON_LEFT_BUMPER,  4);
-            MAP_BUTTON(ImGuiKey_GamepadR1,        GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER, 5);
-            MAP_ANALOG(ImGuiKey_GamepadL2,        GLFW_GAMEPAD_AXIS_LEFT_TRIGGER,   4, -0.75f, +1.0f);
-            MAP_ANALOG(ImGuiKey_GamepadR2,        GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER,  5, -0.75f, +1.0f);
-            MAP_BUTTON(ImGuiKey_GamepadL3,        GLFW_GAMEPAD_BUTTON_LEFT_THUMB,   8);
-            MAP_BUTTON(ImGuiKey_GamepadR3,        GLFW_GAMEPAD_BUTTON_RIGHT_THUMB,  9);
-            // clang-format on
+        for (const auto& mapping : default_gamepad_axes) {
+            float v = gamepad_axis_value(values, mapping);
+            io.AddKeyAnalogEvent(mapping.key, v > profile.threshold, v);
         }
-    };
 
-    // query gamepad support
-    for (uint joystick = GLFW_JOYSTICK_1; joystick <= GLFW_JOYSTICK_LAST; joystick++)
-        if (glfwJoystickPresent(joystick) && glfwJoystickIsGamepad(joystick))
-            update_joystick_events(joystick);
+        connected = true;
+        present |= 1u << joystick;
+    }
+
+    gamepad_connects.add(std::popcount(present & ~gamepad_mask));
+    gamepads.set(std::popcount(present));
+    gamepad_mask = present;
+
+    if (connected) {
+        io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
+    } else if (io.BackendFlags & ImGuiBackendFlags_HasGamepad) {
+        // release all gamepad keys once the last gamepad is gone
+        io.BackendFlags &= ~ImGuiBackendFlags_HasGamepad;
+        for (const auto& mapping : default_gamepad_buttons)
+            io.AddKeyEvent(mapping.key, false);
+        for (const auto& mapping : default_gamepad_axes)
+            io.AddKeyAnalogEvent(mapping.key, false, 0.0f);
+    }
 }
 
 void Application::fonts()
@@ -278,6 +358,4 @@ void Application::fonts()
     io.Fonts->AddFontFromMemoryTTF(icon_data, icon_font.size(), ICON_FONT_SIZE * xscale, &icon_cfg, icons_ranges);
     io.Fonts->AddFontFromMemoryTTF(pmpt_data, pmpt_font.size(), PMPT_FONT_SIZE * xscale, &pmpt_cfg, pmpts_ranges);
     io.Fonts->Build();
-
-    ImGui_ImplOpenGL3_CreateFontsTexture();
 }
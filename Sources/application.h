@@ -1,35 +1,99 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include <array>
+#include <memory>
 #include <GLFW/glfw3.h>
 
 #include "logger.h"
+#include "arena.h"
+#include "allocations.h"
+#include "gamepad.h"
+#include "latency.h"
+#include "limiter.h"
+#include "profiler.h"
+#include "redraw.h"
+#include "tasks.h"
+#include "trace.h"
+#include "platform.h"
+#include "renderer.h"
 
 using uint = uint32_t;
 
 struct Application
 {
+    // vsync, or vsync off with frames paced by the limiter
+    enum PresentMode
+    {
+        VSync,
+        Limited,
+    };
+
     virtual void run();
 
+    // one iteration of the main loop, between setup() and cleanup()
+    virtual void frame();
+
     virtual void tick();
 
     virtual void theme();
 
     virtual void setup();
 
+    // steps of setup(), other startup work can be added around them
+    struct SetupTasks
+    {
+        TaskGraph::Task window   = 0; // platform window and GL context
+        TaskGraph::Task renderer = 0; // renderer backend and frame profiler
+        TaskGraph::Task scale    = 0; // content scale of the window
+        TaskGraph::Task fonts    = 0; // font atlas, baked off the main thread
+        TaskGraph::Task upload   = 0; // font texture
+        TaskGraph::Task present  = 0; // swap interval and frame pacing
+    };
+
+    virtual void setup_tasks(TaskGraph& graph, SetupTasks& tasks);
+
     virtual void cleanup();
 
     virtual void gamepad();
 
+    // builds the font atlas at xscale, the texture is created by the renderer
     virtual void fonts();
 
-    GLFWwindow* window    = nullptr;
-    std::string title     = "Application";
-    uint        width     = 0;
-    uint        height    = 0;
-    bool        decorated = true;
-    float       xscale    = 1.0f;
-    float       yscale    = 1.0f;
+    // apply present_mode, frame_rate and gpu_finish, again after the display mode changed
+    void configure_present();
+
+    std::string title        = "Application";
+    uint        width        = 0;
+    uint        height       = 0;
+    bool        decorated    = true;
+    bool        visible      = true;
+    float       xscale       = 1.0f;
+    float       yscale       = 1.0f;
+    int         refresh_rate = 60;
+    PresentMode present_mode = VSync;
+    int         frame_rate   = 0;     // limiter rate, the refresh rate when 0
+    bool        gpu_finish   = false; // glFinish after each swap, no frames queued ahead of the GPU
+
+    std::unique_ptr<Platform> platform{};
+    std::unique_ptr<Renderer> renderer{};
+
+    GamepadProfiles gamepad_profiles{};
+    LatencyTracker  latency{};
+    FrameProfiler   profiler{};
+    RedrawFilter    redraw{};
+    InputTracer     tracer{};
+    FrameLimiter    limiter{};
+
+    // UI temporaries, reset at the start of every frame
+    FrameArena arena{};
+
+    // heap allocations of the last frame's UI pass (gamepad, tick, render)
+    AllocationStats frame_allocations{};
+
+    std::array<GLFWgamepadstate, GLFW_JOYSTICK_LAST + 1> gamepad_states{};
+    uint32_t                                             gamepad_mask = 0; // connected last frame
+    bool                                                 presented    = true; // last frame was swapped
 }; // end of class Application
 
 #endif // APPLICATION_H
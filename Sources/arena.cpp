@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <cstdarg>
+#include <cstdint>
+#include <algorithm>
+
+#include "arena.h"
+
+static char* align_up(char* ptr, size_t align)
+{
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    return ptr + ((align - address % align) % align);
+}
+
+FrameArena::FrameArena(size_t capacity) : block(std::make_unique<char[]>(capacity)), size(capacity) {}
+
+void* FrameArena::allocate(size_t size, size_t align)
+{
+    char* base  = block.get();
+    char* start = align_up(base + offset, align);
+    if (start + size <= base + this->size) {
+        offset = static_cast<size_t>(start - base) + size;
+        used_bytes += size;
+        return start;
+    }
+
+    // rare, the next reset() makes room for a frame like this one
+    overflow.push_back(std::make_unique<char[]>(size + align));
+    used_bytes += size;
+    return align_up(overflow.back().get(), align);
+}
+
+const char* FrameArena::format(const char* fmt, ...)
+{
+    va_list args, retry;
+    va_start(args, fmt);
+    va_copy(retry, args);
+
+    // straight into the block, formatted twice only when it does not fit
+    char*  dst       = block.get() + offset;
+    size_t available = size - offset;
+    int    length    = std::vsnprintf(dst, available, fmt, args);
+    va_end(args);
+
+    if (length < 0) {
+        va_end(retry);
+        return "";
+    }
+
+    if (static_cast<size_t>(length) < available) {
+        offset += length + 1;
+        used_bytes += length + 1;
+        va_end(retry);
+        return dst;
+    }
+
+    char* out = static_cast<char*>(allocate(length + 1, 1));
+    std::vsnprintf(out, length + 1, fmt, retry);
+    va_end(retry);
+    return out;
+}
+
+void FrameArena::reset()
+{
+    if (!overflow.empty()) {
+        size  = std::max(size * 2, used_bytes * 2);
+        block = std::make_unique<char[]>(size);
+        overflow.clear();
+    }
+    offset     = 0;
+    used_bytes = 0;
+}
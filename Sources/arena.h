@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+// Bump allocator for UI temporaries that live until the end of the frame.
+// The block is kept across frames, a frame that outgrows it gets a bigger one on reset().
+struct FrameArena
+{
+    explicit FrameArena(size_t capacity = 16 * 1024);
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // printf into the arena, valid until the next reset()
+    const char* format(const char* fmt, ...);
+
+    // release the frame's allocations
+    void reset();
+
+    size_t used() const { return used_bytes; }
+    size_t capacity() const { return size; }
+
+private:
+    std::unique_ptr<char[]>              block{};
+    size_t                               size       = 0;
+    size_t                               offset     = 0;
+    size_t                               used_bytes = 0; // including overflow
+    std::vector<std::unique_ptr<char[]>> overflow{};     // allocations past the block, until reset()
+};
+
+#endif // ARENA_H
@@ -0,0 +1,338 @@
+#include <fstream>
+#include <algorithm>
+
+#define TOML_EXCEPTIONS 0
+#include <toml++/toml.hpp>
+
+#include "logger.h"
+#include "config.h"
+
+const char* default_config = R"""([[resolutions]]
+name = "HD"
+freq = 60
+scale = 1.5
+width = 1920
+height = 1080
+
+[[resolutions]]
+name = "2K"
+freq = 60
+scale = 1.5
+width = 2560
+height = 1440
+
+[[resolutions]]
+name = "4K"
+freq = 60
+scale = 1.5
+width = 3840
+height = 2160
+
+# [[resolutions]]
+# name = "TV"
+# freq = 60
+# scale = 2.0
+# width = 3840
+# height = 2160
+# monitor = ["\\\\.\\DISPLAY2", "LG TV"] # GDI or monitor names, the primary display when omitted
+
+# [[libraries]]
+# type = "steam"        # installed Steam games, other library folders are found from here
+# path = "C:\\Program Files (x86)\\Steam"
+# [[libraries]]
+# type = "folder"       # shortcuts (.lnk, .url) and executables in a folder
+# path = "C:\\Users\\Public\\Desktop"
+
+# [covers]
+# budget = 128          # MiB of decoded cover art kept on the GPU
+
+# [present]
+# mode = "vsync"        # vsync, or limiter: vsync off with frames paced by a precise sleep
+# fps = 0               # limiter rate, 0 for the refresh rate
+# finish = false        # glFinish after each swap, no frames queued ahead of the GPU
+
+# [metrics]
+# path = "C:\\Program Files\\windows_exporter\\textfile_inputs\\moonlight-launcher.prom"
+# interval = 15         # seconds between exports
+
+# [[gamepads]]
+# guid = ""             # empty for all gamepads, or a GLFW gamepad GUID
+# deadzone = 0.25       # radial stick deadzone
+# trigger_deadzone = -0.75
+# threshold = 0.10
+# response = 1.0        # response curve exponent
+# [gamepads.buttons]
+# face_down = 1         # swap A/B
+
+[[apps]]
+name = "CMD"
+elevated = false
+# affinity = [0, 1, 2, 3, 4, 5] # cores the app may run on, all when omitted
+# reserved = [6, 7]             # cores kept free for Sunshine's encoder
+# priority = "above_normal"     # idle, below_normal, normal, above_normal, high
+# io_priority = "normal"        # very_low, low, normal, high
+# prefetch = ["C:\\Games\\Game\\game.exe", "C:\\Games\\Game\\data"] # read ahead while highlighted
+# cover = "C:\\Games\\Game\\cover.png"  # portrait art for the grid view (png, jpg, bmp)
+commands = """
+start "" "cmd.exe"
+""")""";
+
+void create_default_config_file(const std::filesystem::path& path)
+{
+    std::ofstream file(path, std::ios::out);
+    file << default_config;
+    file.close();
+}
+
+static bool parse_table(toml::table& table, Config& config)
+{
+    // parse resolutions (optional, the supported modes are listed anyway)
+    if (auto* resolutions = table["resolutions"].as_array()) {
+        for (auto& elem : *resolutions) {
+            auto* item   = elem.as_table();
+            auto  name   = item->get("name")->value_or("");
+            auto  freq   = item->get("freq")->value_or(60);
+            auto  scale  = item->get("scale")->value_or(1.0f);
+            auto  width  = item->get("width")->value_or(0);
+            auto  height = item->get("height")->value_or(0);
+
+            // sanity check
+            if (scale < 1.0f) {
+                Logger::error("[resolutions] expect scale >= 1.0f!");
+                return false;
+            }
+
+            // sanity check
+            if (width <= 0 || height <= 0) {
+                Logger::error("[resolutions] expect width/height > 0!");
+                return false;
+            }
+
+            // sanity check
+            if (freq <= 0) {
+                Logger::error("[resolutions] expect frequency > 0!");
+                return false;
+            }
+
+            // target monitors, a single name or a list of names
+            std::vector<std::string> monitors{};
+            if (auto* monitor = item->get_as<std::string>("monitor")) {
+                monitors.push_back(monitor->get());
+            } else if (auto* list = item->get_as<toml::array>("monitor")) {
+                for (auto& entry : *list) {
+                    if (auto value = entry.value<std::string>())
+                        monitors.push_back(*value);
+                }
+            }
+
+            config.display_settings.push_back(
+                DisplaySettings{name, width, height, freq, scale, monitors});
+        }
+    }
+
+    // parse applications (optional, e.g. only imported from libraries)
+    if (auto* apps = table["apps"].as_array()) {
+        for (auto& elem : *apps) {
+            auto* item     = elem.as_table();
+            auto  name     = item->get("name")->value_or<std::string>("");
+            auto  elevated = item->get("elevated")->value_or(false);
+            auto  commands = item->get("commands")->value_or<std::string>("");
+
+            // sanity check
+            if (name.empty()) {
+                Logger::error("[apps] expect non-empty name!");
+                return false;
+            }
+
+            // sanity check
+            if (commands.empty()) {
+                Logger::error("[apps] expect non-empty commands for {}!", name);
+                return false;
+            }
+
+            // scheduling (optional), cores as lists of indices
+            ProcessOptions process{};
+            for (auto [key, mask] : {std::make_pair("affinity", &process.affinity), std::make_pair("reserved", &process.reserved)}) {
+                if (auto* cores = item->get_as<toml::array>(key)) {
+                    for (auto& core : *cores) {
+                        auto index = core.value_or(-1);
+                        if (index < 0 || index >= 64) {
+                            Logger::error("[apps] expect {} cores in [0, 64) for {}!", key, name);
+                            return false;
+                        }
+                        *mask |= 1ull << index;
+                    }
+                }
+            }
+
+            auto priority = item->get_as<std::string>("priority");
+            if (priority && !set_priority_class(process, priority->get())) {
+                Logger::error("[apps] invalid priority {} for {}!", priority->get(), name);
+                return false;
+            }
+
+            auto io_priority = item->get_as<std::string>("io_priority");
+            if (io_priority && !set_io_priority(process, io_priority->get())) {
+                Logger::error("[apps] invalid io_priority {} for {}!", io_priority->get(), name);
+                return false;
+            }
+
+            // files read ahead while the app is highlighted (optional)
+            std::vector<std::string> prefetch{};
+            if (auto* list = item->get_as<toml::array>("prefetch")) {
+                for (auto& entry : *list) {
+                    if (auto value = entry.value<std::string>())
+                        prefetch.push_back(*value);
+                }
+            }
+
+            // portrait art for the grid view (optional)
+            auto cover = (*item)["cover"].value_or<std::string>("");
+
+            config.application_launchers.push_back(
+                AppLauncher{name, script_name(name), elevated, commands, process, prefetch, cover});
+        }
+    }
+
+    // game libraries to import apps from (optional)
+    if (auto* libraries = table["libraries"].as_array()) {
+        for (auto& elem : *libraries) {
+            auto& item = *elem.as_table();
+
+            LibrarySource source{};
+            source.type = item["type"].value_or<std::string>("");
+            source.path = item["path"].value_or<std::string>("");
+
+            // sanity check
+            if (source.type != "steam" && source.type != "folder") {
+                Logger::error("[libraries] expect type steam or folder!");
+                return false;
+            }
+
+            // sanity check
+            if (source.path.empty()) {
+                Logger::error("[libraries] expect non-empty path!");
+                return false;
+            }
+
+            config.libraries.push_back(source);
+        }
+    }
+
+    // cover art cache (optional)
+    if (auto* covers = table["covers"].as_table()) {
+        config.cover_budget = (*covers)["budget"].value_or(config.cover_budget);
+
+        // sanity check
+        if (config.cover_budget <= 0) {
+            Logger::error("[covers] expect budget > 0!");
+            return false;
+        }
+    }
+
+    // present mode (optional)
+    if (auto* present = table["present"].as_table()) {
+        config.present_mode   = (*present)["mode"].value_or<std::string>("vsync");
+        config.present_fps    = (*present)["fps"].value_or(config.present_fps);
+        config.present_finish = (*present)["finish"].value_or(config.present_finish);
+
+        // sanity check
+        if (config.present_mode != "vsync" && config.present_mode != "limiter") {
+            Logger::error("[present] expect mode vsync or limiter!");
+            return false;
+        }
+
+        // sanity check
+        if (config.present_fps < 0) {
+            Logger::error("[present] expect fps >= 0!");
+            return false;
+        }
+    }
+
+    // metrics export for the node exporter's textfile collector (optional)
+    if (auto* metrics = table["metrics"].as_table()) {
+        config.metrics_path     = (*metrics)["path"].value_or<std::string>("");
+        config.metrics_interval = (*metrics)["interval"].value_or(config.metrics_interval);
+
+        // sanity check
+        if (config.metrics_interval <= 0) {
+            Logger::error("[metrics] expect interval > 0!");
+            return false;
+        }
+    }
+
+    // parse gamepad profiles (optional)
+    if (auto* gamepads = table["gamepads"].as_array()) {
+        for (auto& elem : *gamepads) {
+            auto& item = *elem.as_table();
+
+            GamepadProfile profile{};
+            profile.guid             = item["guid"].value_or<std::string>("");
+            profile.stick_deadzone   = item["deadzone"].value_or(profile.stick_deadzone);
+            profile.trigger_deadzone = item["trigger_deadzone"].value_or(profile.trigger_deadzone);
+            profile.threshold        = item["threshold"].value_or(profile.threshold);
+            profile.response         = item["response"].value_or(profile.response);
+
+            // sanity check
+            if (profile.stick_deadzone < 0.0f || profile.stick_deadzone >= 1.0f) {
+                Logger::error("[gamepads] expect 0.0 <= deadzone < 1.0!");
+                return false;
+            }
+
+            // sanity check
+            if (profile.trigger_deadzone < -1.0f || profile.trigger_deadzone >= 1.0f) {
+                Logger::error("[gamepads] expect -1.0 <= trigger_deadzone < 1.0!");
+                return false;
+            }
+
+            // sanity check
+            if (profile.response <= 0.0f) {
+                Logger::error("[gamepads] expect response > 0!");
+                return false;
+            }
+
+            // button overrides, e.g. face_down = 1
+            if (auto* buttons = item["buttons"].as_table()) {
+                for (auto&& [key, node] : *buttons) {
+                    auto button = node.value_or(-1);
+                    if (!remap_gamepad_button(profile, std::string(key.str()), button)) {
+                        Logger::error("[gamepads] invalid button mapping {} = {}!", key.str(), button);
+                        return false;
+                    }
+                }
+            }
+
+            if (profile.guid.empty()) {
+                config.gamepad_profiles.fallback = profile;
+            } else {
+                config.gamepad_profiles.overrides[profile.guid] = profile;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool parse_config(std::string_view content, Config& config)
+{
+    toml::parse_result result = toml::parse(content);
+    if (!result) {
+        Logger::error("Failed to parse toml config!");
+        return false;
+    }
+
+    toml::table table = std::move(result).table();
+    return parse_table(table, config);
+}
+
+bool load_config(const std::filesystem::path& path, Config& config)
+{
+    toml::parse_result result = toml::parse_file(path.c_str());
+    if (!result) {
+        Logger::error("Failed to parse toml config file!");
+        return false;
+    }
+
+    toml::table table = std::move(result).table();
+    return parse_table(table, config);
+}
@@ -0,0 +1,37 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "display.h"
+#include "gamepad.h"
+#include "launcher.h"
+#include "library.h"
+
+// Contents of moonlight-launcher.toml.
+struct Config
+{
+    std::vector<DisplaySettings> display_settings{};
+    std::vector<AppLauncher>     application_launchers{};
+    GamepadProfiles              gamepad_profiles{};
+    std::vector<LibrarySource>   libraries{};
+    int                          cover_budget     = 128;     // MiB of textures kept for cover art
+    std::string                  metrics_path     = "";      // OpenMetrics text file, none when empty
+    int                          metrics_interval = 15;      // seconds between exports
+    std::string                  present_mode     = "vsync"; // vsync or limiter
+    int                          present_fps      = 0;       // limiter rate, the refresh rate when 0
+    bool                         present_finish   = false;   // glFinish after each swap
+};
+
+// the config written on first launch
+extern const char* default_config;
+
+void create_default_config_file(const std::filesystem::path& path);
+
+bool parse_config(std::string_view content, Config& config);
+
+bool load_config(const std::filesystem::path& path, Config& config);
+
+#endif // CONFIG_H
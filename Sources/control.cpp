@@ -0,0 +1,367 @@
+#include <cstring>
+#include <algorithm>
+
+#include "ipc.h"
+#include "logger.h"
+#include "control.h"
+
+#define CONTROL_INSTANCES 4
+#define CONTROL_BUFFER    (64 * 1024)
+
+// ---------------------------------------------------------------------------
+
+void ControlWriter::u8(uint8_t value)
+{
+    buffer.push_back(static_cast<char>(value));
+}
+
+void ControlWriter::u32(uint32_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void ControlWriter::u64(uint64_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void ControlWriter::i32(int32_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void ControlWriter::f32(float value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void ControlWriter::str(std::string_view value)
+{
+    uint16_t size = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+    buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    buffer.append(value.data(), size);
+}
+
+bool ControlReader::read(void* value, size_t size)
+{
+    if (!ok || offset + size > data.size()) {
+        ok = false;
+        std::memset(value, 0, size);
+        return false;
+    }
+
+    std::memcpy(value, data.data() + offset, size);
+    offset += size;
+    return true;
+}
+
+uint8_t ControlReader::u8()
+{
+    uint8_t value;
+    read(&value, sizeof(value));
+    return value;
+}
+
+uint32_t ControlReader::u32()
+{
+    uint32_t value;
+    read(&value, sizeof(value));
+    return value;
+}
+
+uint64_t ControlReader::u64()
+{
+    uint64_t value;
+    read(&value, sizeof(value));
+    return value;
+}
+
+int32_t ControlReader::i32()
+{
+    int32_t value;
+    read(&value, sizeof(value));
+    return value;
+}
+
+float ControlReader::f32()
+{
+    float value;
+    read(&value, sizeof(value));
+    return value;
+}
+
+std::string ControlReader::str()
+{
+    uint16_t size;
+    if (!read(&size, sizeof(size)) || offset + size > data.size()) {
+        ok = false;
+        return "";
+    }
+
+    std::string value(data.substr(offset, size));
+    offset += size;
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+
+// one pipe instance, cycling connect -> read -> write -> read ... -> disconnect
+struct ControlConnection
+{
+    enum State
+    {
+        Connecting,
+        Reading,
+        Writing,
+    };
+
+    HANDLE      pipe = INVALID_HANDLE_VALUE;
+    OVERLAPPED  overlapped{};
+    State       state = Connecting;
+    std::string input{};
+    std::string output{};
+    char        buffer[4096];
+};
+
+static bool begin_read(ControlConnection& conn)
+{
+    conn.state = ControlConnection::Reading;
+    return ReadFile(conn.pipe, conn.buffer, sizeof(conn.buffer), nullptr, &conn.overlapped) || GetLastError() == ERROR_IO_PENDING;
+}
+
+static bool begin_write(ControlConnection& conn)
+{
+    conn.state = ControlConnection::Writing;
+    return WriteFile(conn.pipe, conn.output.data(), static_cast<DWORD>(conn.output.size()), nullptr, &conn.overlapped) || GetLastError() == ERROR_IO_PENDING;
+}
+
+static bool begin_connect(ControlConnection& conn)
+{
+    conn.state = ControlConnection::Connecting;
+    conn.input.clear();
+    conn.output.clear();
+    ResetEvent(conn.overlapped.hEvent);
+    if (ConnectNamedPipe(conn.pipe, &conn.overlapped) || GetLastError() == ERROR_IO_PENDING)
+        return true;
+
+    // the client connected between CreateNamedPipe/DisconnectNamedPipe and now
+    return GetLastError() == ERROR_PIPE_CONNECTED && begin_read(conn);
+}
+
+static void reconnect(ControlConnection& conn)
+{
+    DisconnectNamedPipe(conn.pipe);
+    if (!begin_connect(conn))
+        Logger::error("[Control] Failed to accept connections ({})!", GetLastError());
+}
+
+ControlServer::~ControlServer()
+{
+    stop();
+}
+
+bool ControlServer::start(Handler handler, const std::string& name)
+{
+    this->handler = std::move(handler);
+    this->name    = name;
+
+    // local clients of the current user only, ApplyMode and Launch must not be reachable over SMB
+    SECURITY_ATTRIBUTES* security = pipe_security();
+    if (!security)
+        return false;
+
+    for (int i = 0; i < CONTROL_INSTANCES; i++) {
+        DWORD  access = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (i == 0 ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+        DWORD  mode   = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS;
+        HANDLE pipe   = CreateNamedPipeA(name.c_str(), access, mode, CONTROL_INSTANCES, CONTROL_BUFFER, CONTROL_BUFFER, 0, security);
+        if (pipe == INVALID_HANDLE_VALUE) {
+            Logger::error("[Control] Failed to create pipe {} ({})!", name, GetLastError());
+            for (HANDLE created : pipes)
+                CloseHandle(created);
+            pipes.clear();
+            return false;
+        }
+        pipes.push_back(pipe);
+    }
+
+    stop_event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    thread     = std::thread([this]() { loop(); });
+
+    Logger::info("[Control] Listening on {}", name);
+    return true;
+}
+
+void ControlServer::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    SetEvent(stop_event);
+    thread.join();
+
+    for (HANDLE pipe : pipes)
+        CloseHandle(pipe);
+    pipes.clear();
+
+    CloseHandle(stop_event);
+    stop_event = nullptr;
+}
+
+void ControlServer::loop()
+{
+    const DWORD count = static_cast<DWORD>(pipes.size());
+
+    std::vector<ControlConnection> connections(count);
+    std::vector<HANDLE>            events(count + 1);
+    for (DWORD i = 0; i < count; i++) {
+        auto& conn             = connections[i];
+        conn.pipe              = pipes[i];
+        conn.overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        events[i]              = conn.overlapped.hEvent;
+        if (!begin_connect(conn))
+            Logger::error("[Control] Failed to accept connections ({})!", GetLastError());
+    }
+    events[count] = stop_event;
+
+    while (true) {
+        DWORD index = WaitForMultipleObjects(count + 1, events.data(), FALSE, INFINITE) - WAIT_OBJECT_0;
+        if (index >= count)
+            break;
+
+        auto& conn  = connections[index];
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(conn.pipe, &conn.overlapped, &bytes, FALSE)) {
+            // client went away
+            reconnect(conn);
+            continue;
+        }
+
+        bool ok = true;
+        switch (conn.state) {
+            case ControlConnection::Connecting:
+                ok = begin_read(conn);
+                break;
+
+            case ControlConnection::Reading: {
+                conn.input.append(conn.buffer, bytes);
+
+                // answer every complete frame, pipelined requests arrive in one read
+                size_t offset = 0;
+                while (ok && conn.input.size() - offset >= sizeof(uint32_t)) {
+                    uint32_t size;
+                    std::memcpy(&size, conn.input.data() + offset, sizeof(size));
+                    if (size > CONTROL_MAX_FRAME) {
+                        Logger::warn("[Control] Dropping client, frame of {} bytes is too large!", size);
+                        ok = false;
+                        break;
+                    }
+                    if (conn.input.size() - offset - sizeof(uint32_t) < size)
+                        break;
+
+                    std::string response = handler(std::string_view(conn.input).substr(offset + sizeof(uint32_t), size));
+                    uint32_t    length   = static_cast<uint32_t>(response.size());
+                    Logger::trace("[Control] {} byte request, {} byte response", size, length);
+                    conn.output.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                    conn.output.append(response);
+                    offset += sizeof(uint32_t) + size;
+                    requests++;
+                }
+                conn.input.erase(0, offset);
+
+                if (ok)
+                    ok = conn.output.empty() ? begin_read(conn) : begin_write(conn);
+                break;
+            }
+
+            case ControlConnection::Writing:
+                conn.output.erase(0, bytes);
+                ok = conn.output.empty() ? begin_read(conn) : begin_write(conn);
+                break;
+        }
+
+        if (!ok)
+            reconnect(conn);
+    }
+
+    // wait for outstanding I/O before the OVERLAPPED structures go away
+    for (auto& conn : connections) {
+        DWORD bytes = 0;
+        CancelIoEx(conn.pipe, &conn.overlapped);
+        GetOverlappedResult(conn.pipe, &conn.overlapped, &bytes, TRUE);
+        CloseHandle(conn.overlapped.hEvent);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+static bool write_all(HANDLE pipe, const char* data, size_t size)
+{
+    while (size > 0) {
+        DWORD written = 0;
+        if (!WriteFile(pipe, data, static_cast<DWORD>(size), &written, nullptr))
+            return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool read_all(HANDLE pipe, char* data, size_t size)
+{
+    while (size > 0) {
+        DWORD read = 0;
+        if (!ReadFile(pipe, data, static_cast<DWORD>(size), &read, nullptr) || read == 0)
+            return false;
+        data += read;
+        size -= read;
+    }
+    return true;
+}
+
+ControlClient::~ControlClient()
+{
+    disconnect();
+}
+
+bool ControlClient::connect(const std::string& name, uint32_t timeout_ms)
+{
+    disconnect();
+
+    pipe = CreateFileA(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY && WaitNamedPipeA(name.c_str(), timeout_ms))
+        pipe = CreateFileA(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+
+    return pipe != INVALID_HANDLE_VALUE;
+}
+
+void ControlClient::disconnect()
+{
+    if (pipe != INVALID_HANDLE_VALUE)
+        CloseHandle(pipe);
+    pipe = INVALID_HANDLE_VALUE;
+}
+
+bool ControlClient::send(std::string_view payload)
+{
+    std::string frame;
+    uint32_t    length = static_cast<uint32_t>(payload.size());
+    frame.reserve(sizeof(length) + payload.size());
+    frame.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    frame.append(payload);
+    return write_all(pipe, frame.data(), frame.size());
+}
+
+bool ControlClient::receive(std::string& payload)
+{
+    uint32_t length = 0;
+    if (!read_all(pipe, reinterpret_cast<char*>(&length), sizeof(length)) || length > CONTROL_MAX_FRAME)
+        return false;
+
+    payload.resize(length);
+    return read_all(pipe, payload.data(), length);
+}
+
+bool ControlClient::request(std::string_view payload, std::string& response)
+{
+    return send(payload) && receive(response);
+}
@@ -0,0 +1,123 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+#include <Windows.h>
+#undef min
+#undef max
+
+// Local control protocol for scripts, served next to the UI.
+//
+// Every request and response is a frame: u32 payload length, then the payload.
+// Requests start with a u8 ControlCommand, responses with a u8 ControlStatus.
+// Integers and floats are little-endian, strings are u16 length + bytes.
+// Several requests may be written before reading, responses come back in order.
+//
+//   ListModes             -> u32 count, count x (u8 preset, str name, i32 width, i32 height, i32 freq, f32 scale)
+//   ApplyMode  i32 w, h   ->
+//   ApplyScale f32 scale  ->
+//   Launch     str name   ->
+//   Status                -> i32 width, i32 height, i32 freq, f32 scale, u8 resident, u64 requests
+#define CONTROL_PIPE_NAME "\\\\.\\pipe\\Moonlight-Launcher-Control"
+#define CONTROL_MAX_FRAME (64 * 1024)
+
+enum class ControlCommand : uint8_t
+{
+    ListModes  = 1,
+    ApplyMode  = 2,
+    ApplyScale = 3,
+    Launch     = 4,
+    Status     = 5,
+};
+
+enum class ControlStatus : uint8_t
+{
+    Ok             = 0,
+    Failed         = 1,
+    BadRequest     = 2,
+    NotFound       = 3,
+    UnknownCommand = 4,
+};
+
+struct ControlWriter
+{
+    void u8(uint8_t value);
+    void u32(uint32_t value);
+    void u64(uint64_t value);
+    void i32(int32_t value);
+    void f32(float value);
+    void str(std::string_view value);
+
+    std::string buffer{};
+};
+
+// Reads past the end yield zeros and clear `ok`.
+struct ControlReader
+{
+    explicit ControlReader(std::string_view data) : data(data) {}
+
+    uint8_t     u8();
+    uint32_t    u32();
+    uint64_t    u64();
+    int32_t     i32();
+    float       f32();
+    std::string str();
+
+    std::string_view data{};
+    size_t           offset = 0;
+    bool             ok     = true;
+
+private:
+    bool read(void* value, size_t size);
+};
+
+// Serves the control pipe from an overlapped I/O event loop on its own thread.
+struct ControlServer
+{
+    // request payload in, response payload out; called on the server thread
+    using Handler = std::function<std::string(std::string_view request)>;
+
+    ~ControlServer();
+
+    bool start(Handler handler, const std::string& name = CONTROL_PIPE_NAME);
+
+    void stop();
+
+    Handler               handler{};
+    std::string           name{};
+    std::thread           thread{};
+    std::vector<HANDLE>   pipes{};
+    HANDLE                stop_event = nullptr;
+    std::atomic<uint64_t> requests   = 0;
+
+private:
+    void loop();
+};
+
+// Blocking client, requests may be pipelined with send() before receive().
+// Keep less than a pipe buffer (64 KiB) of responses outstanding.
+struct ControlClient
+{
+    ~ControlClient();
+
+    bool connect(const std::string& name = CONTROL_PIPE_NAME, uint32_t timeout_ms = 1000);
+
+    void disconnect();
+
+    bool send(std::string_view payload);
+
+    bool receive(std::string& payload);
+
+    bool request(std::string_view payload, std::string& response);
+
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+};
+
+#endif // CONTROL_H
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <filesystem>
+
+#include <Windows.h>
+#include <wincodec.h>
+
+#include "logger.h"
+#include "covers.h"
+#include "metrics.h"
+
+static Gauge& cover_textures = metrics().gauge("launcher_cover_textures", "Cover textures on the GPU");
+static Gauge& cover_bytes    = metrics().gauge("launcher_cover_bytes", "Bytes of cover textures on the GPU");
+
+// releases a COM interface when it goes out of scope
+template <typename T>
+struct ComRef
+{
+    ComRef() = default;
+    ComRef(const ComRef&) = delete;
+    ComRef& operator=(const ComRef&) = delete;
+
+    ~ComRef()
+    {
+        if (ptr)
+            ptr->Release();
+    }
+
+    T* operator->() const { return ptr; }
+
+    T* ptr = nullptr;
+};
+
+bool decode_image(const std::string& path, int max_width, int max_height, Image& image)
+{
+    ComRef<IWICImagingFactory> factory;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory.ptr))))
+        return false;
+
+    ComRef<IWICBitmapDecoder>     decoder;
+    ComRef<IWICBitmapFrameDecode> frame;
+    std::wstring                  filename = std::filesystem::path(path).wstring();
+    if (FAILED(factory->CreateDecoderFromFilename(filename.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder.ptr)) ||
+        FAILED(decoder->GetFrame(0, &frame.ptr)))
+        return false;
+
+    UINT width = 0, height = 0;
+    if (FAILED(frame->GetSize(&width, &height)) || width == 0 || height == 0)
+        return false;
+
+    // fit inside the tile with the aspect kept, never upscaled
+    double scale         = std::min({1.0, static_cast<double>(max_width) / width, static_cast<double>(max_height) / height});
+    UINT   scaled_width  = std::max(1u, static_cast<UINT>(width * scale + 0.5));
+    UINT   scaled_height = std::max(1u, static_cast<UINT>(height * scale + 0.5));
+
+    // decoding, scaling and conversion run as one pass in CopyPixels
+    IWICBitmapSource*        source = frame.ptr;
+    ComRef<IWICBitmapScaler> scaler;
+    if (scaled_width != width || scaled_height != height) {
+        if (FAILED(factory->CreateBitmapScaler(&scaler.ptr)) ||
+            FAILED(scaler->Initialize(frame.ptr, scaled_width, scaled_height, WICBitmapInterpolationModeFant)))
+            return false;
+        source = scaler.ptr;
+    }
+
+    ComRef<IWICFormatConverter> converter;
+    if (FAILED(factory->CreateFormatConverter(&converter.ptr)) ||
+        FAILED(converter->Initialize(source, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)))
+        return false;
+
+    image.width  = static_cast<int>(scaled_width);
+    image.height = static_cast<int>(scaled_height);
+    image.pixels.resize(static_cast<size_t>(scaled_width) * scaled_height);
+    return SUCCEEDED(converter->CopyPixels(nullptr, scaled_width * 4, static_cast<UINT>(image.pixels.size() * 4),
+        reinterpret_cast<BYTE*>(image.pixels.data())));
+}
+
+// ---------------------------------------------------------------------------
+
+CoverCache::~CoverCache()
+{
+    stop();
+}
+
+void CoverCache::start(Renderer* renderer, size_t budget, int threads, std::function<void()> wake)
+{
+    stop();
+
+    this->renderer = renderer;
+    this->budget   = budget;
+    this->wake     = std::move(wake);
+    for (int i = 0; i < threads; i++)
+        this->threads.emplace_back(&CoverCache::run, this);
+}
+
+void CoverCache::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queued.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& [path, entry] : entries) {
+        if (entry.state == Entry::Resident)
+            renderer->destroy_texture(entry.cover.texture);
+    }
+    entries.clear();
+    queue.clear();
+    decoded.clear();
+    bytes    = 0;
+    stopping = false;
+    cover_textures.set(0);
+    cover_bytes.set(0);
+}
+
+Cover CoverCache::request(const std::string& path, int width, int height)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (threads.empty())
+        return Cover{};
+
+    auto [it, inserted] = entries.try_emplace(path);
+    auto& entry         = it->second;
+    entry.used          = frame;
+    if (inserted) {
+        entry.width  = width;
+        entry.height = height;
+        queue.push_back(path);
+        queued.notify_one();
+        misses++;
+        return Cover{};
+    }
+
+    if (entry.state != Entry::Resident)
+        return Cover{};
+
+    hits++;
+    return entry.cover;
+}
+
+bool CoverCache::update(std::chrono::microseconds budget)
+{
+    auto begin = Clock::now();
+    bool added = false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    frame++;
+
+    // newest first, the rest waits for the next frame
+    while (!decoded.empty() && Clock::now() - begin < budget) {
+        auto it = entries.find(decoded.back());
+        decoded.pop_back();
+        if (it == entries.end())
+            continue;
+
+        auto& entry = it->second;
+        entry.cover = Cover{renderer->create_texture(entry.image.width, entry.image.height, entry.image.pixels.data()), entry.image.width, entry.image.height};
+        if (!entry.cover.texture) {
+            Logger::error("Failed to create a texture for {}!", it->first);
+            entry.state = Entry::Failed;
+            entry.image = Image{};
+            failures++;
+            continue;
+        }
+
+        Logger::trace("Uploaded cover {} ({}x{})", it->first, entry.image.width, entry.image.height);
+        entry.state = Entry::Resident;
+        entry.bytes = entry.image.pixels.size() * sizeof(uint32_t);
+        entry.image = Image{};
+        bytes += entry.bytes;
+        uploads++;
+        added = true;
+        cover_textures.add(1);
+    }
+
+    evict();
+    cover_bytes.set(static_cast<int64_t>(bytes));
+    return added;
+}
+
+void CoverCache::evict()
+{
+    if (bytes <= budget)
+        return;
+
+    // least recently requested first, covers shown last frame are kept even over budget
+    std::vector<std::pair<uint64_t, const std::string*>> candidates{};
+    for (const auto& [path, entry] : entries) {
+        if (entry.state == Entry::Resident && entry.used + 1 < frame)
+            candidates.emplace_back(entry.used, &path);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& [used, path] : candidates) {
+        if (bytes <= budget)
+            break;
+
+        Logger::debug("Evicted cover {}, last shown {} frames ago", *path, frame - used);
+        auto it = entries.find(*path);
+        renderer->destroy_texture(it->second.cover.texture);
+        bytes -= it->second.bytes;
+        entries.erase(it);
+        evictions++;
+        cover_textures.add(-1);
+    }
+}
+
+size_t CoverCache::textures() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::count_if(entries.begin(), entries.end(), [](const auto& item) { return item.second.state == Entry::Resident; });
+}
+
+size_t CoverCache::resident() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+void CoverCache::run()
+{
+    // WIC is a COM API
+    bool com = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queued.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (stopping)
+            break;
+
+        std::string path = std::move(queue.back());
+        queue.pop_back();
+
+        auto it = entries.find(path);
+        if (it == entries.end())
+            continue;
+
+        // scrolled out of view while queued, requested again when it comes back
+        if (it->second.used + 2 < frame) {
+            entries.erase(it);
+            dropped++;
+            continue;
+        }
+
+        it->second.state = Entry::Decoding;
+        int width        = it->second.width;
+        int height       = it->second.height;
+        lock.unlock();
+
+        Image image{};
+        bool  success = decode_image(path, width, height, image);
+
+        lock.lock();
+        it = entries.find(path);
+        if (it == entries.end())
+            continue;
+
+        if (!success) {
+            Logger::error("Failed to decode cover {}!", path);
+            it->second.state = Entry::Failed;
+            failures++;
+            continue;
+        }
+
+        it->second.state = Entry::Decoded;
+        it->second.image = std::move(image);
+        decoded.push_back(path);
+
+        lock.unlock();
+        if (wake)
+            wake();
+        lock.lock();
+    }
+    lock.unlock();
+
+    if (com)
+        CoUninitialize();
+}
@@ -0,0 +1,109 @@
+#ifndef COVERS_H
+#define COVERS_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "renderer.h"
+
+// Decoded RGBA8 pixels, IM_COL32 layout, rows top to bottom.
+struct Image
+{
+    int                   width  = 0;
+    int                   height = 0;
+    std::vector<uint32_t> pixels{};
+};
+
+// decode a png, jpg or bmp scaled down to fit `max_width` x `max_height`,
+// the calling thread must have initialized COM
+bool decode_image(const std::string& path, int max_width, int max_height, Image& image);
+
+// A cover on the GPU and its size in pixels.
+struct Cover
+{
+    ImTextureID texture = nullptr;
+    int         width   = 0;
+    int         height  = 0;
+};
+
+// Cover art decoded on worker threads and uploaded on the render thread,
+// textures used least recently are released once over the byte budget.
+struct CoverCache
+{
+    using Clock = std::chrono::steady_clock;
+
+    ~CoverCache();
+
+    // `wake` is called from a worker after each decode, the renderer must outlive stop()
+    void start(Renderer* renderer, size_t budget, int threads, std::function<void()> wake);
+
+    // join the workers and release all textures
+    void stop();
+
+    // `path` decoded to fit `width` x `height`, no texture while loading or when decoding failed,
+    // paths not requested for a few frames are dropped from the queue
+    Cover request(const std::string& path, int width, int height);
+
+    // upload decoded images for at most `budget` and evict over the byte budget, true when a texture was added
+    bool update(std::chrono::microseconds budget);
+
+    // textures and bytes on the GPU
+    size_t textures() const;
+    size_t resident() const;
+
+    std::atomic<uint64_t> hits{0};      // requests answered with a texture
+    std::atomic<uint64_t> misses{0};    // requests that queued a decode
+    std::atomic<uint64_t> uploads{0};   // textures created
+    std::atomic<uint64_t> evictions{0}; // textures released over the budget
+    std::atomic<uint64_t> failures{0};  // images that failed to decode
+    std::atomic<uint64_t> dropped{0};   // queued decodes scrolled out of view
+
+private:
+    struct Entry
+    {
+        enum State
+        {
+            Queued,
+            Decoding,
+            Decoded,
+            Resident,
+            Failed,
+        };
+
+        State    state  = Queued;
+        int      width  = 0; // requested
+        int      height = 0;
+        uint64_t used   = 0; // frame of the last request
+        size_t   bytes  = 0;
+        Cover    cover{};
+        Image    image{};
+    };
+
+    void run();
+
+    void evict();
+
+    Renderer*             renderer = nullptr;
+    size_t                budget   = 0;
+    size_t                bytes    = 0; // resident
+    uint64_t              frame    = 0;
+    std::function<void()> wake{};
+
+    mutable std::mutex                     mutex{};
+    std::condition_variable                queued{};
+    std::unordered_map<std::string, Entry> entries{};
+    std::vector<std::string>               queue{};   // newest last, decoded first
+    std::vector<std::string>               decoded{}; // waiting for upload
+    std::vector<std::thread>               threads{};
+    bool                                   stopping = false;
+};
+
+#endif // COVERS_H
@@ -1,26 +1,22 @@
+#include <future>
 #include <algorithm>
 #include <DpiHelper.h>
 #include <spdlog/spdlog.h>
 
 #include "logger.h"
 #include "display.h"
+#include "metrics.h"
+#include "session.h"
 
 using uint = uint32_t;
 
+static Counter& mode_switches = metrics().counter("launcher_mode_switches", "Display mode and scale changes applied");
+static Counter& mode_failures = metrics().counter("launcher_mode_switch_failures", "Display mode or scale changes that failed");
+
 std::vector<DisplaySettings> list_display_settings()
 {
     std::vector<DisplaySettings> display_settings{};
 
-    auto update_display_settings = [&](const DisplaySettings& settings) {
-        for (auto& config : display_settings) {
-            if (config.width == settings.width && config.height == settings.height) {
-                config.frequency = std::max(config.frequency, settings.frequency);
-                return;
-            }
-        }
-        display_settings.push_back(settings);
-    };
-
     int modeNum = 0;
 
     DEVMODE dm;
@@ -34,14 +30,62 @@ std::vector<DisplaySettings> list_display_settings()
         settings.frequency = dm.dmDisplayFrequency;
         settings.scale     = dm.dmScale;
         modeNum++;
-        update_display_settings(settings);
+        merge_display_settings(display_settings, settings);
+    }
+
+    sort_display_settings(display_settings);
+    return display_settings;
+}
+
+void merge_display_settings(std::vector<DisplaySettings>& display_settings, const DisplaySettings& settings)
+{
+    for (auto& config : display_settings) {
+        if (config.width == settings.width && config.height == settings.height) {
+            config.frequency = std::max(config.frequency, settings.frequency);
+            return;
+        }
     }
+    display_settings.push_back(settings);
+}
 
+void sort_display_settings(std::vector<DisplaySettings>& display_settings)
+{
     std::sort(display_settings.begin(), display_settings.end(), [&](const auto& lhs, const auto& rhs) {
         return lhs.width != rhs.width ? (lhs.width > rhs.width) : (lhs.height > rhs.height);
     });
+}
 
-    return display_settings;
+const DisplaySettings* find_display_settings(const std::vector<DisplaySettings>& display_settings, int width, int height)
+{
+    for (const auto& settings : display_settings) {
+        if (settings.width == width && settings.height == height)
+            return &settings;
+    }
+    return nullptr;
+}
+
+static std::string to_utf8(const WCHAR* text)
+{
+    int size = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+    if (size <= 1)
+        return "";
+
+    std::string result(size - 1, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text, -1, result.data(), size, nullptr, nullptr);
+    return result;
+}
+
+static std::string primary_device_name()
+{
+    DISPLAY_DEVICEA device;
+    ZeroMemory(&device, sizeof(device));
+    device.cb = sizeof(device);
+
+    for (DWORD index = 0; EnumDisplayDevicesA(NULL, index, &device, 0); index++) {
+        if (device.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE)
+            return device.DeviceName;
+    }
+    return "";
 }
 
 // https://github.com/imniko/SetDPI/blob/master/SetDpi.cpp
@@ -56,6 +100,8 @@ std::vector<DisplayData> get_display_data()
         Logger::error("DpiHelper::GetPathsAndModes() failed");
     }
 
+    std::string primary = primary_device_name();
+
     displayDataCache.resize(pathsV.size());
     int idx = 0;
     for (const auto& path : pathsV) {
@@ -69,17 +115,25 @@ std::vector<DisplayData> get_display_data()
         deviceName.header.type      = DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME;
         deviceName.header.adapterId = adapterLUID;
         deviceName.header.id        = targetID;
-        if (ERROR_SUCCESS != DisplayConfigGetDeviceInfo(&deviceName.header)) {
+
+        // GDI name of the source, used by ChangeDisplaySettingsEx()
+        DISPLAYCONFIG_SOURCE_DEVICE_NAME sourceName;
+        sourceName.header.size      = sizeof(sourceName);
+        sourceName.header.type      = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+        sourceName.header.adapterId = adapterLUID;
+        sourceName.header.id        = sourceID;
+
+        if (ERROR_SUCCESS != DisplayConfigGetDeviceInfo(&deviceName.header) ||
+            ERROR_SUCCESS != DisplayConfigGetDeviceInfo(&sourceName.header)) {
             Logger::error("DisplayConfigGetDeviceInfo() failed!");
         } else {
-            std::wstring nameString = std::to_wstring(idx) + std::wstring(L". ") + deviceName.monitorFriendlyDeviceName;
-            if (DISPLAYCONFIG_OUTPUT_TECHNOLOGY_INTERNAL == deviceName.outputTechnology) {
-                nameString += L"(internal display)";
-            }
-            DisplayData dd = {};
-            dd.m_adapterId = adapterLUID;
-            dd.m_sourceID  = sourceID;
-            dd.m_targetID  = targetID;
+            DisplayData dd    = {};
+            dd.m_adapterId    = adapterLUID;
+            dd.m_sourceID     = sourceID;
+            dd.m_targetID     = targetID;
+            dd.m_deviceName   = to_utf8(sourceName.viewGdiDeviceName);
+            dd.m_friendlyName = to_utf8(deviceName.monitorFriendlyDeviceName);
+            dd.m_primary      = dd.m_deviceName == primary;
 
             displayDataCache[idx] = dd;
         }
@@ -88,49 +142,325 @@ std::vector<DisplayData> get_display_data()
     return displayDataCache;
 }
 
-bool update_resolution(int width, int height)
+// ---------------------------------------------------------------------------
+
+static LRESULT CALLBACK display_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    switch (msg) {
+        case WM_DISPLAYCHANGE:
+            if (auto* topology = reinterpret_cast<DisplayTopology*>(GetWindowLongPtrA(hwnd, GWLP_USERDATA)))
+                topology->invalidate();
+            break;
+
+        // DPI scale changes are broadcast as setting changes
+        case WM_SETTINGCHANGE:
+            if (auto* topology = reinterpret_cast<DisplayTopology*>(GetWindowLongPtrA(hwnd, GWLP_USERDATA)))
+                topology->notify();
+            break;
+
+        case WM_DESTROY:
+            PostQuitMessage(0);
+            break;
+    }
+    return DefWindowProcA(hwnd, msg, wparam, lparam);
+}
+
+DisplayTopology::~DisplayTopology()
 {
-    // initialize DEVMODE structure
+    stop();
+}
+
+void DisplayTopology::watch()
+{
+    if (thread.joinable())
+        return;
+
+    std::promise<void> created;
+    std::future<void>  ready = created.get_future();
+
+    thread = std::thread([this, &created]() {
+        WNDCLASSA wc{};
+        wc.lpfnWndProc   = display_proc;
+        wc.hInstance     = GetModuleHandleA(nullptr);
+        wc.lpszClassName = "Moonlight-Launcher-Display";
+        RegisterClassA(&wc);
+
+        // hidden top-level window, message-only windows do not get broadcasts
+        window = CreateWindowExA(0, wc.lpszClassName, "", 0, 0, 0, 0, 0, nullptr, nullptr, wc.hInstance, nullptr);
+        if (window)
+            SetWindowLongPtrA(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+        created.set_value();
+        if (!window) {
+            Logger::error("Failed to create display change listener ({})!", GetLastError());
+            return;
+        }
+
+        MSG msg;
+        while (GetMessageA(&msg, nullptr, 0, 0) > 0)
+            DispatchMessageA(&msg);
+    });
+
+    ready.wait();
+}
+
+void DisplayTopology::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    if (window)
+        PostMessageA(window, WM_CLOSE, 0, 0);
+    thread.join();
+    window = nullptr;
+}
+
+void DisplayTopology::notify()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        last_change = Clock::now();
+        changes++;
+    }
+    changed.notify_all();
+}
+
+void DisplayTopology::invalidate()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        valid = false;
+    }
+    notify();
+}
+
+void DisplayTopology::expect()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // a scale change right after a mode change, the mode's notifications count too
+    if (!pending)
+        since = changes;
+    pending  = true;
+    expected = Clock::now();
+}
+
+bool DisplayTopology::settle(std::chrono::milliseconds quiet, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!pending)
+        return true;
+    pending = false;
+
+    // without a listener there is nothing to wait on
+    if (!thread.joinable()) {
+        lock.unlock();
+        std::this_thread::sleep_for(quiet);
+        return true;
+    }
+
+    // first notification, then until they stop for `quiet`
+    const auto deadline = expected + timeout;
+    bool       settled  = changed.wait_until(lock, deadline, [&]() { return changes > since; });
+    while (settled) {
+        uint64_t seen = changes;
+        if (!changed.wait_until(lock, std::min(last_change + quiet, deadline), [&]() { return changes > seen; })) {
+            // by the notifications, settle() may be called long after the deadline
+            settled = last_change + quiet <= deadline;
+            break;
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        (settled ? last_change : Clock::now()) - expected);
+    if (settled) {
+        Logger::info("Display settled after {} ms ({} notifications).", elapsed.count(), changes - since);
+    } else {
+        Logger::warn("Display did not settle within {} ms.", timeout.count());
+    }
+    return settled;
+}
+
+std::vector<DisplayData> DisplayTopology::data()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // without a listener there is no telling when the cache goes stale
+    if (!valid || !thread.joinable()) {
+        cache = get_display_data();
+        valid = true;
+    }
+    return cache;
+}
+
+std::vector<DisplayData> DisplayTopology::find(const std::vector<std::string>& monitors)
+{
+    std::vector<DisplayData> displays = data();
+    std::vector<DisplayData> targets{};
+
+    if (monitors.empty()) {
+        auto it = std::find_if(displays.begin(), displays.end(), [](const DisplayData& display) { return display.m_primary; });
+        if (it != displays.end()) {
+            targets.push_back(*it);
+        } else if (!displays.empty()) {
+            targets.push_back(displays.front());
+        }
+        return targets;
+    }
+
+    for (const auto& monitor : monitors) {
+        auto it = std::find_if(displays.begin(), displays.end(), [&](const DisplayData& display) {
+            return display.m_deviceName == monitor || display.m_friendlyName == monitor;
+        });
+
+        if (it == displays.end()) {
+            Logger::error("Monitor {} not found!", monitor);
+            continue;
+        }
+        targets.push_back(*it);
+    }
+    return targets;
+}
+
+DisplayTopology& display_topology()
+{
+    static DisplayTopology topology;
+    return topology;
+}
+
+// ---------------------------------------------------------------------------
+
+DisplaySettings get_current_display_settings()
+{
+    DisplaySettings settings{"", 0, 0, 0, 1.0f};
+
     DEVMODE dm;
     ZeroMemory(&dm, sizeof(dm));
     dm.dmSize = sizeof(dm);
+    if (EnumDisplaySettings(NULL, ENUM_CURRENT_SETTINGS, &dm)) {
+        settings.width     = dm.dmPelsWidth;
+        settings.height    = dm.dmPelsHeight;
+        settings.frequency = dm.dmDisplayFrequency;
+    }
 
-    // get current display settings
-    if (!EnumDisplaySettings(NULL, ENUM_CURRENT_SETTINGS, &dm)) {
-        Logger::error("Could not get current display settings!");
-        return false;
+    auto primary = display_topology().find({});
+    if (!primary.empty()) {
+        auto info      = DpiHelper::GetDPIScalingInfo(primary[0].m_adapterId, primary[0].m_sourceID);
+        settings.scale = info.current / 100.0f;
     }
 
-    // set new display resolution
-    dm.dmPelsWidth  = width;
-    dm.dmPelsHeight = height;
-    dm.dmFields     = DM_PELSWIDTH | DM_PELSHEIGHT;
+    return settings;
+}
+
+bool update_resolution(int width, int height, int frequency, const std::vector<std::string>& monitors)
+{
+    begin_display_session();
+
+    // primary display through the NULL device when the topology is unknown
+    std::vector<std::string> devices{};
+    for (const auto& display : display_topology().find(monitors))
+        devices.push_back(display.m_deviceName);
+    if (devices.empty() && monitors.empty())
+        devices.push_back("");
+    if (devices.empty())
+        return false;
+
+    bool success = true;
+    bool staged  = false;
+    for (const auto& device : devices) {
+        const char* name = device.empty() ? NULL : device.c_str();
+
+        // initialize DEVMODE structure
+        DEVMODEA dm;
+        ZeroMemory(&dm, sizeof(dm));
+        dm.dmSize = sizeof(dm);
+
+        // get current display settings
+        if (!EnumDisplaySettingsA(name, ENUM_CURRENT_SETTINGS, &dm)) {
+            Logger::error("Could not get current display settings of {}!", device);
+            success = false;
+            continue;
+        }
+
+        // already current, no change and no notification to wait for
+        bool same_rate = frequency <= 0 || dm.dmDisplayFrequency == static_cast<DWORD>(frequency);
+        if (dm.dmPelsWidth == static_cast<DWORD>(width) && dm.dmPelsHeight == static_cast<DWORD>(height) && same_rate)
+            continue;
+        if (!staged)
+            display_topology().expect();
+        staged = true;
+
+        // set new display resolution
+        dm.dmPelsWidth  = width;
+        dm.dmPelsHeight = height;
+        dm.dmFields     = DM_PELSWIDTH | DM_PELSHEIGHT;
+        if (frequency > 0) {
+            dm.dmDisplayFrequency = frequency;
+            dm.dmFields |= DM_DISPLAYFREQUENCY;
+        }
+
+        // stage the new settings, applied together below
+        DWORD flags  = CDS_UPDATEREGISTRY | CDS_GLOBAL | CDS_NORESET;
+        LONG  result = ChangeDisplaySettingsExA(name, &dm, NULL, flags, NULL);
+        if (result != DISP_CHANGE_SUCCESSFUL) {
+            Logger::error("Display resolution change failed for {}.", device);
+            success = false;
+        }
+    }
 
-    // apply the new settings
-    DWORD flags  = CDS_UPDATEREGISTRY | CDS_GLOBAL;
-    LONG  result = ChangeDisplaySettings(&dm, flags);
+    if (!staged) {
+        Logger::debug("Display resolution already {}x{}@{} Hz.", width, height, frequency);
+        return success;
+    }
 
-    if (result != DISP_CHANGE_SUCCESSFUL) {
+    // one mode set for every staged display
+    if (ChangeDisplaySettingsExA(NULL, NULL, NULL, 0, NULL) != DISP_CHANGE_SUCCESSFUL) {
         Logger::error("Display resolution change failed.");
         return false;
     }
 
-    Logger::info("Display resolution changed to {}x{}.", width, height);
-    return true;
+    if (success)
+        Logger::info("Display resolution changed to {}x{}@{} Hz.", width, height, frequency);
+    return success;
 }
 
-bool update_scale(float scale)
+bool update_scale(float scale, const std::vector<std::string>& monitors)
 {
-    uint displayIndex = 0;
-    uint dpiToSet     = static_cast<uint32_t>(scale * 100.0);
+    begin_display_session();
 
-    auto displayDataCache = get_display_data();
+    uint dpiToSet = static_cast<uint32_t>(scale * 100.0);
 
-    bool success = DpiHelper::SetDPIScaling(displayDataCache[displayIndex].m_adapterId, displayDataCache[displayIndex].m_sourceID, dpiToSet);
-    if (!success) {
-        Logger::error("DpiHelper::SetDPIScaling() failed!");
+    auto displays = display_topology().find(monitors);
+    if (displays.empty()) {
+        Logger::error("No display to scale!");
         return false;
     }
 
-    return true;
+    bool success  = true;
+    bool changing = false;
+    for (const auto& display : displays) {
+        // already current, no change and no notification to wait for
+        if (DpiHelper::GetDPIScalingInfo(display.m_adapterId, display.m_sourceID).current == dpiToSet)
+            continue;
+        if (!changing)
+            display_topology().expect();
+        changing = true;
+
+        if (!DpiHelper::SetDPIScaling(display.m_adapterId, display.m_sourceID, dpiToSet)) {
+            Logger::error("DpiHelper::SetDPIScaling() failed!");
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+bool apply_display_settings(const DisplaySettings& settings)
+{
+    bool resolution = update_resolution(settings.width, settings.height, settings.frequency, settings.monitors);
+    bool scale      = update_scale(settings.scale, settings.monitors);
+
+    mode_switches.add();
+    if (!resolution || !scale)
+        mode_failures.add();
+    return resolution && scale;
 }
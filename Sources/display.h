@@ -1,8 +1,13 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
+#include <mutex>
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
+#include <condition_variable>
 
 #include <Windows.h>
 #undef min
@@ -18,6 +23,9 @@ struct DisplaySettings
     int   height;
     int   frequency;
     float scale;
+
+    // friendly or GDI device names (\\.\DISPLAY2), the primary display when empty
+    std::vector<std::string> monitors{};
 };
 
 // https://github.com/imniko/SetDPI/blob/master/SetDpi.cpp
@@ -27,20 +35,87 @@ struct DisplayData
     int  m_targetID;
     int  m_sourceID;
 
+    std::string m_deviceName;   // GDI name, e.g. \\.\DISPLAY1
+    std::string m_friendlyName; // monitor name reported by EDID
+    bool        m_primary;
+
     DisplayData()
     {
         m_adapterId = {};
         m_targetID = m_sourceID = -1;
+        m_primary  = false;
     }
 };
 
+// Display topology cache, only re-queried after WM_DISPLAYCHANGE.
+struct DisplayTopology
+{
+    using Clock = std::chrono::steady_clock;
+
+    ~DisplayTopology();
+
+    // listen for display changes on a background thread
+    void watch();
+
+    void stop();
+
+    // a display or settings change notification, wakes settle()
+    void notify();
+
+    // notify() and drop the cached topology
+    void invalidate();
+
+    // a mode or scale change is about to be applied, called by update_resolution()
+    // and update_scale() only when they change something
+    void expect();
+
+    // block until the notifications for the expected change have stopped for `quiet`,
+    // at most `timeout` after expect(); false on timeout
+    bool settle(std::chrono::milliseconds quiet = std::chrono::milliseconds(250),
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(3000));
+
+    std::vector<DisplayData> data();
+
+    // display targets by name, the primary display for an empty list
+    std::vector<DisplayData> find(const std::vector<std::string>& monitors);
+
+    std::mutex               mutex{};
+    std::condition_variable  changed{};
+    std::vector<DisplayData> cache{};
+    bool                     valid   = false;
+    std::atomic<uint64_t>    changes = 0; // notification count
+    bool                     pending = false;
+    uint64_t                 since   = 0; // notification count at expect()
+    Clock::time_point        expected{};
+    Clock::time_point        last_change{};
+    std::thread              thread{};
+    HWND                     window = nullptr;
+};
+
+DisplayTopology& display_topology();
+
 std::vector<DisplaySettings> list_display_settings();
 
+// keep one entry per resolution, at its highest refresh rate
+void merge_display_settings(std::vector<DisplaySettings>& display_settings, const DisplaySettings& settings);
+
+// largest resolution first
+void sort_display_settings(std::vector<DisplaySettings>& display_settings);
+
+const DisplaySettings* find_display_settings(const std::vector<DisplaySettings>& display_settings, int width, int height);
+
 // https://github.com/imniko/SetDPI/blob/master/SetDpi.cpp
 std::vector<DisplayData> get_display_data();
 
-bool update_resolution(int width, int height);
+// current mode and DPI scale of the primary display
+DisplaySettings get_current_display_settings();
+
+// the refresh rate is kept when `frequency` is 0
+bool update_resolution(int width, int height, int frequency = 0, const std::vector<std::string>& monitors = {});
+
+bool update_scale(float scale, const std::vector<std::string>& monitors = {});
 
-bool update_scale(float scale);
+// resolution and scale on every target monitor, mode changes are committed together
+bool apply_display_settings(const DisplaySettings& settings);
 
 #endif // DISPLAY_H
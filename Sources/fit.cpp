@@ -0,0 +1,79 @@
+#include <cmath>
+
+#include "fit.h"
+
+// clang-format off
+constexpr float FIT_ASPECT_WEIGHT  = 4.0f;  // per log unit of aspect ratio mismatch
+constexpr float FIT_UPSCALE_WEIGHT = 2.0f;  // upscaled streams lose detail, downscaled only cost encoder time
+constexpr float FIT_REFRESH_WEIGHT = 1.0f;  // per missing fraction of the client refresh rate
+constexpr float FIT_EXCESS_WEIGHT  = 0.01f; // per extra fraction above the client refresh rate
+constexpr float FIT_INTEGER_BONUS  = 0.25f; // exact integer downscale, no filtering artifacts
+// clang-format on
+
+// common Moonlight clients: phones, handhelds, laptops and TVs
+// clang-format off
+static const int common_extents[][2] = {
+    {1280,  720}, {1280,  800}, {1366,  768}, {1600,  900}, {1920, 1080}, {1920, 1200},
+    {2560, 1080}, {2560, 1440}, {2560, 1600}, {2796, 1290}, {2532, 1170}, {3440, 1440},
+    {3840, 2160}, {2388, 1668}, {2732, 2048}, {2340, 1080}, {2400, 1080},
+};
+// clang-format on
+
+float score_display_mode(const DisplaySettings& mode, int width, int height, int frequency)
+{
+    float mode_aspect   = static_cast<float>(mode.width) / mode.height;
+    float client_aspect = static_cast<float>(width) / height;
+    float aspect        = std::fabs(std::log(mode_aspect / client_aspect));
+
+    // log of the pixel count ratio, > 0 when the host has more pixels than the client
+    float pixels = std::log(static_cast<float>(mode.width) * mode.height / (static_cast<float>(width) * height));
+    float scale  = pixels >= 0.0f ? pixels : -FIT_UPSCALE_WEIGHT * pixels;
+
+    float refresh = 0.0f;
+    if (mode.frequency < frequency) {
+        refresh = FIT_REFRESH_WEIGHT * (frequency - mode.frequency) / frequency;
+    } else {
+        refresh = FIT_EXCESS_WEIGHT * (mode.frequency - frequency) / frequency;
+    }
+
+    bool integer = mode.width % width == 0 && mode.height % height == 0 && mode.width / width == mode.height / height;
+    return FIT_ASPECT_WEIGHT * aspect + scale + refresh - (integer ? FIT_INTEGER_BONUS : 0.0f);
+}
+
+void ModeFitter::reset(const std::vector<DisplaySettings>& display_settings)
+{
+    modes = display_settings;
+    cache.clear();
+}
+
+void ModeFitter::precompute()
+{
+    for (const auto& extent : common_extents) {
+        best(extent[0], extent[1], 60);
+        best(extent[1], extent[0], 60); // portrait
+    }
+}
+
+const DisplaySettings* ModeFitter::best(int width, int height, int frequency)
+{
+    if (modes.empty() || width <= 0 || height <= 0 || frequency <= 0)
+        return nullptr;
+
+    uint64_t key = (static_cast<uint64_t>(width) << 40) | (static_cast<uint64_t>(height) << 16) | static_cast<uint64_t>(frequency);
+    auto     it  = cache.find(key);
+    if (it != cache.end())
+        return &modes[it->second];
+
+    int   index = 0;
+    float score = score_display_mode(modes[0], width, height, frequency);
+    for (int i = 1; i < static_cast<int>(modes.size()); i++) {
+        float s = score_display_mode(modes[i], width, height, frequency);
+        if (s < score) {
+            score = s;
+            index = i;
+        }
+    }
+
+    cache.emplace(key, index);
+    return &modes[index];
+}
@@ -0,0 +1,30 @@
+#ifndef FIT_H
+#define FIT_H
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "display.h"
+
+// Cost of streaming a client extent from a host mode, lower is better.
+// Penalizes aspect mismatch, upscaling, a lower refresh than the client asks for,
+// and rewards exact integer downscales.
+float score_display_mode(const DisplaySettings& mode, int width, int height, int frequency);
+
+// Best supported mode per client extent, memoized.
+struct ModeFitter
+{
+    void reset(const std::vector<DisplaySettings>& display_settings);
+
+    // score the common client extents up front
+    void precompute();
+
+    // nullptr when there are no modes
+    const DisplaySettings* best(int width, int height, int frequency = 60);
+
+    std::vector<DisplaySettings>      modes{};
+    std::unordered_map<uint64_t, int> cache{}; // client extent -> mode index
+};
+
+#endif // FIT_H
@@ -0,0 +1,65 @@
+#include <cmath>
+#include <algorithm>
+
+#include "gamepad.h"
+
+const GamepadProfile& GamepadProfiles::find(const char* guid) const
+{
+    if (guid) {
+        auto it = overrides.find(guid);
+        if (it != overrides.end())
+            return it->second;
+    }
+    return fallback;
+}
+
+std::array<float, GAMEPAD_AXIS_COUNT> apply_gamepad_profile(const GamepadProfile& profile, const float* axes)
+{
+    const float lx = axes[GLFW_GAMEPAD_AXIS_LEFT_X];
+    const float ly = axes[GLFW_GAMEPAD_AXIS_LEFT_Y];
+    const float rx = axes[GLFW_GAMEPAD_AXIS_RIGHT_X];
+    const float ry = axes[GLFW_GAMEPAD_AXIS_RIGHT_Y];
+    const float lt = axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER];
+    const float rt = axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER];
+
+    // sticks use the length of the stick vector (radial deadzone),
+    // triggers are moved from [-1, 1] to [0, 1] so both share one formula
+    const float l_len = std::sqrt(lx * lx + ly * ly);
+    const float r_len = std::sqrt(rx * rx + ry * ry);
+    const float s_dz  = std::clamp(profile.stick_deadzone, 0.0f, 0.99f);
+    const float t_dz  = (std::clamp(profile.trigger_deadzone, -1.0f, 0.99f) + 1.0f) * 0.5f;
+
+    // clang-format off
+    const float magnitude[GAMEPAD_AXIS_COUNT] = { l_len, l_len, r_len, r_len, (lt + 1.0f) * 0.5f, (rt + 1.0f) * 0.5f };
+    const float deadzone[GAMEPAD_AXIS_COUNT]  = { s_dz,  s_dz,  s_dz,  s_dz,  t_dz,               t_dz               };
+    const float direction[GAMEPAD_AXIS_COUNT] = {
+        l_len > 0.0f ? lx / l_len : 0.0f,
+        l_len > 0.0f ? ly / l_len : 0.0f,
+        r_len > 0.0f ? rx / r_len : 0.0f,
+        r_len > 0.0f ? ry / r_len : 0.0f,
+        1.0f,
+        1.0f,
+    };
+    // clang-format on
+
+    std::array<float, GAMEPAD_AXIS_COUNT> values{};
+    for (int i = 0; i < GAMEPAD_AXIS_COUNT; i++) {
+        float t   = std::clamp((magnitude[i] - deadzone[i]) / (1.0f - deadzone[i]), 0.0f, 1.0f);
+        values[i] = direction[i] * (profile.response == 1.0f ? t : std::pow(t, profile.response));
+    }
+    return values;
+}
+
+bool remap_gamepad_button(GamepadProfile& profile, const std::string& name, int button)
+{
+    if (button < 0 || button > GLFW_GAMEPAD_BUTTON_LAST)
+        return false;
+
+    for (auto& mapping : profile.buttons) {
+        if (name == mapping.name) {
+            mapping.button = button;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+#ifndef GAMEPAD_H
+#define GAMEPAD_H
+
+#include <map>
+#include <array>
+#include <string>
+#include <algorithm>
+#include <imgui.h>
+#include <GLFW/glfw3.h>
+
+constexpr int GAMEPAD_AXIS_COUNT = GLFW_GAMEPAD_AXIS_LAST + 1;
+
+struct GamepadButtonMapping
+{
+    const char* name;
+    ImGuiKey    key;
+    int         button;
+};
+
+struct GamepadAxisMapping
+{
+    ImGuiKey key;
+    int      axis;
+    float    sign;
+};
+
+// clang-format off
+constexpr std::array<GamepadButtonMapping, 14> default_gamepad_buttons = {{
+    {"start",       ImGuiKey_GamepadStart,     GLFW_GAMEPAD_BUTTON_START        },
+    {"back",        ImGuiKey_GamepadBack,      GLFW_GAMEPAD_BUTTON_BACK         },
+    {"face_left",   ImGuiKey_GamepadFaceLeft,  GLFW_GAMEPAD_BUTTON_X            }, // Xbox X, PS Square
+    {"face_right",  ImGuiKey_GamepadFaceRight, GLFW_GAMEPAD_BUTTON_B            }, // Xbox B, PS Circle
+    {"face_up",     ImGuiKey_GamepadFaceUp,    GLFW_GAMEPAD_BUTTON_Y            }, // Xbox Y, PS Triangle
+    {"face_down",   ImGuiKey_GamepadFaceDown,  GLFW_GAMEPAD_BUTTON_A            }, // Xbox A, PS Cross
+    {"dpad_left",   ImGuiKey_GamepadDpadLeft,  GLFW_GAMEPAD_BUTTON_DPAD_LEFT    },
+    {"dpad_right",  ImGuiKey_GamepadDpadRight, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT   },
+    {"dpad_up",     ImGuiKey_GamepadDpadUp,    GLFW_GAMEPAD_BUTTON_DPAD_UP      },
+    {"dpad_down",   ImGuiKey_GamepadDpadDown,  GLFW_GAMEPAD_BUTTON_DPAD_DOWN    },
+    {"l1",          ImGuiKey_GamepadL1,        GLFW_GAMEPAD_BUTTON_LEFT_BUMPER  },
+    {"r1",          ImGuiKey_GamepadR1,        GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER },
+    {"l3",          ImGuiKey_GamepadL3,        GLFW_GAMEPAD_BUTTON_LEFT_THUMB   },
+    {"r3",          ImGuiKey_GamepadR3,        GLFW_GAMEPAD_BUTTON_RIGHT_THUMB  },
+}};
+
+constexpr std::array<GamepadAxisMapping, 10> default_gamepad_axes = {{
+    {ImGuiKey_GamepadLStickLeft,  GLFW_GAMEPAD_AXIS_LEFT_X,        -1.0f },
+    {ImGuiKey_GamepadLStickRight, GLFW_GAMEPAD_AXIS_LEFT_X,        +1.0f },
+    {ImGuiKey_GamepadLStickUp,    GLFW_GAMEPAD_AXIS_LEFT_Y,        -1.0f },
+    {ImGuiKey_GamepadLStickDown,  GLFW_GAMEPAD_AXIS_LEFT_Y,        +1.0f },
+    {ImGuiKey_GamepadRStickLeft,  GLFW_GAMEPAD_AXIS_RIGHT_X,       -1.0f },
+    {ImGuiKey_GamepadRStickRight, GLFW_GAMEPAD_AXIS_RIGHT_X,       +1.0f },
+    {ImGuiKey_GamepadRStickUp,    GLFW_GAMEPAD_AXIS_RIGHT_Y,       -1.0f },
+    {ImGuiKey_GamepadRStickDown,  GLFW_GAMEPAD_AXIS_RIGHT_Y,       +1.0f },
+    {ImGuiKey_GamepadL2,          GLFW_GAMEPAD_AXIS_LEFT_TRIGGER,  +1.0f },
+    {ImGuiKey_GamepadR2,          GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER, +1.0f },
+}};
+// clang-format on
+
+struct GamepadProfile
+{
+    std::string guid             = "";
+    float       stick_deadzone   = 0.25f;  // radial, in [0, 1)
+    float       trigger_deadzone = -0.75f; // triggers rest at -1
+    float       threshold        = 0.10f;  // analog value counted as pressed
+    float       response         = 1.0f;   // response curve exponent
+
+    std::array<GamepadButtonMapping, default_gamepad_buttons.size()> buttons = default_gamepad_buttons;
+};
+
+struct GamepadProfiles
+{
+    GamepadProfile                                     fallback{};
+    std::map<std::string, GamepadProfile, std::less<>> overrides{}; // looked up by const char* without a copy
+
+    const GamepadProfile& find(const char* guid) const;
+};
+
+// Remap raw GLFW gamepad axes to [0, 1] (sticks keep their sign) in one pass.
+std::array<float, GAMEPAD_AXIS_COUNT> apply_gamepad_profile(const GamepadProfile& profile, const float* axes);
+
+// Analog value of an axis key in the remapped axes, pressed above the profile's threshold.
+inline float gamepad_axis_value(const std::array<float, GAMEPAD_AXIS_COUNT>& values, const GamepadAxisMapping& mapping)
+{
+    return std::max(0.0f, mapping.sign * values[mapping.axis]);
+}
+
+// Rebind a button of the profile by its mapping name, e.g. "face_down".
+bool remap_gamepad_button(GamepadProfile& profile, const std::string& name, int button);
+
+#endif // GAMEPAD_H
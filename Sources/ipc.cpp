@@ -0,0 +1,138 @@
+#include <string>
+
+#include "logger.h"
+#include "ipc.h"
+
+#include <sddl.h>
+
+static HANDLE create_pipe(bool first)
+{
+    SECURITY_ATTRIBUTES* security = pipe_security();
+    if (!security)
+        return INVALID_HANDLE_VALUE;
+
+    DWORD access = PIPE_ACCESS_INBOUND | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+    DWORD mode   = PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS;
+    return CreateNamedPipeA(IPC_PIPE_NAME, access, mode, 1, 0, sizeof(IpcMessage), 0, security);
+}
+
+SECURITY_ATTRIBUTES* pipe_security()
+{
+    // built once, the descriptor lives as long as the process
+    static SECURITY_ATTRIBUTES attributes = []() {
+        SECURITY_ATTRIBUTES result{sizeof(SECURITY_ATTRIBUTES), nullptr, FALSE};
+
+        HANDLE token = nullptr;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) {
+            Logger::error("[IPC] Failed to open the process token ({})!", GetLastError());
+            return result;
+        }
+
+        DWORD size = 0;
+        GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+        std::vector<uint8_t> user(size);
+
+        LPSTR sid = nullptr;
+        if (size > 0 && GetTokenInformation(token, TokenUser, user.data(), size, &size) &&
+            ConvertSidToStringSidA(reinterpret_cast<TOKEN_USER*>(user.data())->User.Sid, &sid)) {
+            // protected DACL, full access for the user's own SID and nobody else
+            std::string sddl = std::string("D:P(A;;GA;;;") + sid + ")";
+            if (!ConvertStringSecurityDescriptorToSecurityDescriptorA(sddl.c_str(), SDDL_REVISION_1, &result.lpSecurityDescriptor, nullptr))
+                result.lpSecurityDescriptor = nullptr;
+            LocalFree(sid);
+        }
+        CloseHandle(token);
+
+        if (!result.lpSecurityDescriptor)
+            Logger::error("[IPC] Failed to build the pipe security descriptor ({})!", GetLastError());
+        return result;
+    }();
+
+    return attributes.lpSecurityDescriptor ? &attributes : nullptr;
+}
+
+IpcServer::~IpcServer()
+{
+    stop();
+}
+
+bool IpcServer::start(std::function<void()> wake)
+{
+    // the first instance decides which process is resident
+    pipe = create_pipe(true);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        Logger::error("[IPC] Failed to create pipe {} ({})!", IPC_PIPE_NAME, GetLastError());
+        return false;
+    }
+
+    this->wake = std::move(wake);
+    running    = true;
+    thread     = std::thread([this]() {
+        while (running) {
+            bool connected = ConnectNamedPipe(pipe, nullptr) || GetLastError() == ERROR_PIPE_CONNECTED;
+
+            IpcMessage message{};
+            DWORD      bytes = 0;
+            if (connected && running && ReadFile(pipe, &message, sizeof(message), &bytes, nullptr) && bytes == sizeof(message)) {
+                Logger::debug("[IPC] Request {} for {}x{}@{}", static_cast<int>(message.type), message.width, message.height, message.frequency);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    messages.push_back(message);
+                }
+                this->wake();
+            }
+
+            DisconnectNamedPipe(pipe);
+        }
+    });
+
+    Logger::info("[IPC] Listening on {}", IPC_PIPE_NAME);
+    return true;
+}
+
+void IpcServer::stop()
+{
+    if (!running)
+        return;
+
+    // unblock ConnectNamedPipe() with a connection of our own
+    running     = false;
+    HANDLE self = CreateFileA(IPC_PIPE_NAME, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (self != INVALID_HANDLE_VALUE)
+        CloseHandle(self);
+
+    thread.join();
+    CloseHandle(pipe);
+    pipe = INVALID_HANDLE_VALUE;
+}
+
+std::vector<IpcMessage> IpcServer::poll()
+{
+    std::vector<IpcMessage> received{};
+
+    std::lock_guard<std::mutex> lock(mutex);
+    received.swap(messages);
+    return received;
+}
+
+bool ipc_send(const IpcMessage& message)
+{
+    HANDLE pipe = CreateFileA(IPC_PIPE_NAME, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        // no resident instance
+        if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(IPC_PIPE_NAME, 1000))
+            return false;
+
+        pipe = CreateFileA(IPC_PIPE_NAME, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (pipe == INVALID_HANDLE_VALUE)
+            return false;
+    }
+
+    // let the resident instance take the foreground from us
+    AllowSetForegroundWindow(ASFW_ANY);
+
+    DWORD bytes   = 0;
+    BOOL  written = WriteFile(pipe, &message, sizeof(message), &bytes, nullptr);
+    CloseHandle(pipe);
+    return written && bytes == sizeof(message);
+}
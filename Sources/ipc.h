@@ -0,0 +1,61 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include <Windows.h>
+#undef min
+#undef max
+
+#define IPC_PIPE_NAME "\\\\.\\pipe\\Moonlight-Launcher"
+
+enum class IpcType : uint32_t
+{
+    Show = 1, // show the window for a new session
+    Quit = 2, // shut the resident launcher down
+};
+
+// One pipe message, sent as-is.
+struct IpcMessage
+{
+    IpcType  type   = IpcType::Show;
+    uint32_t width     = 0; // client extent, 0 to keep the current one
+    uint32_t height    = 0;
+    uint32_t frequency = 0; // client frame rate, 0 for 60
+};
+
+// Receives messages from other launcher instances on a background thread.
+struct IpcServer
+{
+    ~IpcServer();
+
+    // fails when another instance already owns the pipe,
+    // `wake` is called from the server thread after each message
+    bool start(std::function<void()> wake);
+
+    void stop();
+
+    // messages received since the last call
+    std::vector<IpcMessage> poll();
+
+    std::thread             thread{};
+    std::mutex              mutex{};
+    std::atomic<bool>       running = false;
+    std::vector<IpcMessage> messages{};
+    std::function<void()>   wake{};
+    HANDLE                  pipe = INVALID_HANDLE_VALUE;
+};
+
+// Pipe security allowing the current user only, nullptr when it cannot be built.
+// Pipes also pass PIPE_REJECT_REMOTE_CLIENTS, no other machine can connect over SMB.
+SECURITY_ATTRIBUTES* pipe_security();
+
+// Sends a message to the resident instance, false when there is none.
+bool ipc_send(const IpcMessage& message);
+
+#endif // IPC_H
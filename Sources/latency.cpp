@@ -0,0 +1,142 @@
+#include <fstream>
+#include <algorithm>
+
+#include "logger.h"
+#include "latency.h"
+#include "metrics.h"
+
+static Histogram& input_latency = metrics().histogram("launcher_input_latency_seconds", "Input to the swap of the first frame reacting to it",
+    {0.004, 0.008, 0.016, 0.025, 0.033, 0.05, 0.066, 0.1, 0.15, 0.25});
+
+LatencyTracker::LatencyTracker(size_t capacity) : capacity(capacity)
+{
+    pending.reserve(64);
+    for (auto& s : samples)
+        s.values.reserve(capacity);
+}
+
+void LatencyTracker::input(Source source, uint delay)
+{
+    if (!enabled)
+        return;
+
+    // only the oldest pending event per source and frame is of interest
+    uint64_t visible = frame + delay;
+    for (const auto& p : pending)
+        if (p.source == source && p.frame == visible)
+            return;
+
+    pending.push_back(Pending{source, visible, Clock::now()});
+}
+
+void LatencyTracker::submit()
+{
+    if (!enabled)
+        return;
+
+    auto now = Clock::now();
+    auto it  = std::remove_if(pending.begin(), pending.end(), [&](const Pending& p) {
+        if (p.frame > frame)
+            return false;
+
+        float ms = std::chrono::duration<float, std::milli>(now - p.time).count();
+        auto& s  = samples[p.source];
+        input_latency.observe(ms / 1000.0);
+        if (s.values.size() < capacity) {
+            s.values.push_back(ms);
+        } else {
+            s.values[s.next] = ms; // overwrite oldest sample
+            s.next           = (s.next + 1) % capacity;
+        }
+        return true;
+    });
+    pending.erase(it, pending.end());
+
+    frame++;
+}
+
+void LatencyTracker::skip()
+{
+    if (!enabled)
+        return;
+
+    auto it = std::remove_if(pending.begin(), pending.end(), [&](const Pending& p) {
+        return p.frame <= frame;
+    });
+    pending.erase(it, pending.end());
+
+    frame++;
+}
+
+auto LatencyTracker::stats(Source source) const -> LatencyStats
+{
+    std::vector<float> values = samples[source].values;
+    if (values.empty())
+        return LatencyStats{};
+
+    auto percentile = [&](float p) {
+        size_t n = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + n, values.end());
+        return values[n];
+    };
+
+    LatencyStats stats{};
+    stats.count = values.size();
+    stats.p50   = percentile(0.50f);
+    stats.p90   = percentile(0.90f);
+    stats.p99   = percentile(0.99f);
+    stats.max   = *std::max_element(values.begin(), values.end());
+    return stats;
+}
+
+auto LatencyTracker::histogram(Source source, size_t bins, float max_ms) const -> std::vector<float>
+{
+    std::vector<float> counts(bins, 0.0f);
+    for (float ms : samples[source].values) {
+        size_t bin = static_cast<size_t>(ms / max_ms * bins);
+        counts[std::min(bin, bins - 1)] += 1.0f;
+    }
+    return counts;
+}
+
+bool LatencyTracker::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out);
+    if (!file) {
+        Logger::error("Failed to write latency report to {}!", path);
+        return false;
+    }
+
+    file << "# present mode: " << mode << "\n";
+    for (int i = 0; i < SourceCount; i++) {
+        auto s = stats(static_cast<Source>(i));
+        file << "# " << source_name(static_cast<Source>(i)) << ": count=" << s.count
+             << " p50=" << s.p50 << " p90=" << s.p90 << " p99=" << s.p99 << " max=" << s.max << "\n";
+
+        // in the log too, to compare present modes run by run
+        if (s.count > 0)
+            Logger::info("Input latency with {}, {}: p50 {:.1f} ms, p99 {:.1f} ms ({} samples)",
+                mode, source_name(static_cast<Source>(i)), s.p50, s.p99, s.count);
+    }
+
+    file << "source,latency_ms\n";
+    for (int i = 0; i < SourceCount; i++)
+        for (float ms : samples[i].values)
+            file << source_name(static_cast<Source>(i)) << "," << ms << "\n";
+
+    Logger::info("Latency report saved to {}", path);
+    return true;
+}
+
+const char* LatencyTracker::source_name(Source source)
+{
+    // clang-format off
+    switch (source)
+    {
+        case Keyboard: return "keyboard";
+        case Mouse:    return "mouse";
+        case Gamepad:  return "gamepad";
+        default:       return "unknown";
+    }
+    // clang-format on
+}
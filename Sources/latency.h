@@ -0,0 +1,76 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using uint = uint32_t;
+
+struct LatencyStats
+{
+    size_t count = 0;
+    float  p50   = 0.0f;
+    float  p90   = 0.0f;
+    float  p99   = 0.0f;
+    float  max   = 0.0f;
+};
+
+// Measures the time between an input event and the return of glfwSwapBuffers()
+// (and glFinish() when throttled) of the first frame that could have reacted to it.
+struct LatencyTracker
+{
+    using Clock = std::chrono::steady_clock;
+
+    enum Source
+    {
+        Keyboard = 0,
+        Mouse,
+        Gamepad,
+        SourceCount,
+    };
+
+    explicit LatencyTracker(size_t capacity = 1024);
+
+    // record an input event, visible `delay` frames after the current one
+    void input(Source source, uint delay = 0);
+
+    // record the submission of the current frame
+    void submit();
+
+    // the current frame was not submitted, its inputs had no visible effect
+    void skip();
+
+    auto stats(Source source) const -> LatencyStats;
+
+    auto histogram(Source source, size_t bins, float max_ms) const -> std::vector<float>;
+
+    bool save(const std::string& path) const;
+
+    static const char* source_name(Source source);
+
+    bool        enabled = false;
+    std::string mode    = ""; // present mode description for reports
+
+private:
+    struct Pending
+    {
+        Source            source;
+        uint64_t          frame;
+        Clock::time_point time;
+    };
+
+    struct Samples
+    {
+        std::vector<float> values{};
+        size_t             next = 0;
+    };
+
+    size_t                           capacity = 0;
+    uint64_t                         frame    = 0;
+    std::vector<Pending>             pending{};
+    std::array<Samples, SourceCount> samples{};
+};
+
+#endif // LATENCY_H
@@ -0,0 +1,233 @@
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+
+#include "path.h"
+#include "logger.h"
+#include "display.h"
+#include "metrics.h"
+#include "launcher.h"
+
+static Counter& launches        = metrics().counter("launcher_launches", "App launches attempted");
+static Counter& launch_failures = metrics().counter("launcher_launch_failures", "App launches whose script failed to start");
+
+// clang-format off
+static const std::pair<const char*, DWORD> priority_classes[] = {
+    {"idle",         IDLE_PRIORITY_CLASS},
+    {"below_normal", BELOW_NORMAL_PRIORITY_CLASS},
+    {"normal",       NORMAL_PRIORITY_CLASS},
+    {"above_normal", ABOVE_NORMAL_PRIORITY_CLASS},
+    {"high",         HIGH_PRIORITY_CLASS},
+};
+
+static const std::pair<const char*, int> io_priorities[] = {
+    {"very_low", 0},
+    {"low",      1},
+    {"normal",   2},
+    {"high",     3},
+};
+// clang-format on
+
+bool set_priority_class(ProcessOptions& options, const std::string& name)
+{
+    for (const auto& [key, value] : priority_classes) {
+        if (name == key) {
+            options.priority_class = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool set_io_priority(ProcessOptions& options, const std::string& name)
+{
+    for (const auto& [key, value] : io_priorities) {
+        if (name == key) {
+            options.io_priority = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t effective_affinity(const ProcessOptions& options, uint64_t system)
+{
+    uint64_t mask = options.affinity ? options.affinity & system : system;
+    return mask & ~options.reserved;
+}
+
+// not in the SDK headers, inherited by child processes like the priority class
+static bool set_process_io_priority(HANDLE process, int io_priority)
+{
+    using NtSetInformationProcess_t = LONG(NTAPI*)(HANDLE, ULONG, PVOID, ULONG);
+    constexpr ULONG ProcessIoPriority = 33;
+
+    static auto NtSetInformationProcess = reinterpret_cast<NtSetInformationProcess_t>(
+        GetProcAddress(GetModuleHandleA("ntdll.dll"), "NtSetInformationProcess"));
+    if (!NtSetInformationProcess)
+        return false;
+
+    ULONG value = static_cast<ULONG>(io_priority);
+    return NtSetInformationProcess(process, ProcessIoPriority, &value, sizeof(value)) >= 0;
+}
+
+static bool apply_process_options(HANDLE process, const ProcessOptions& options)
+{
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    GetProcessAffinityMask(process, &process_mask, &system_mask);
+
+    uint64_t affinity = effective_affinity(options, system_mask);
+    if (!affinity) {
+        Logger::error("No cores left for the app after reserving {:#x}!", options.reserved);
+        return false;
+    }
+
+    // a job carries the limits to every process the script starts,
+    // games started through a launcher that breaks away keep the defaults
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits{};
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_BREAKAWAY_OK;
+    if (options.affinity || options.reserved) {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_AFFINITY;
+        limits.BasicLimitInformation.Affinity = static_cast<ULONG_PTR>(affinity);
+    }
+    if (options.priority_class) {
+        limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PRIORITY_CLASS;
+        limits.BasicLimitInformation.PriorityClass = options.priority_class;
+    }
+
+    // the job lives on without a handle, without kill-on-close the app outlives the launcher
+    bool   success = true;
+    HANDLE job     = CreateJobObjectA(NULL, NULL);
+    if (!job || !SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits)) ||
+        !AssignProcessToJobObject(job, process)) {
+        Logger::error("Failed to assign the app to a job ({}), limits apply to the script only!", GetLastError());
+        if (options.affinity || options.reserved)
+            success &= SetProcessAffinityMask(process, static_cast<DWORD_PTR>(affinity)) != 0;
+        if (options.priority_class)
+            success &= SetPriorityClass(process, options.priority_class) != 0;
+    }
+    if (job)
+        CloseHandle(job);
+
+    if (options.io_priority >= 0 && !set_process_io_priority(process, options.io_priority)) {
+        Logger::error("Failed to set I/O priority {}!", options.io_priority);
+        success = false;
+    }
+
+    if (success)
+        Logger::info("Process affinity {:#x}, priority class {:#x}, I/O priority {}", affinity, options.priority_class, options.io_priority);
+    return success;
+}
+
+std::string script_name(const std::string& name)
+{
+    std::string script = name + ".bat";
+    std::replace_if(script.begin(), script.end(), [](char c) { return std::strchr(" <>:\"/\\|?*", c) != nullptr; }, '_');
+    return script;
+}
+
+HANDLE spawn_process(const std::string& script, bool elevated, const ProcessOptions& options)
+{
+    // elevation goes through the shell, the script may already be running when the options apply
+    if (elevated) {
+        SHELLEXECUTEINFOA info{};
+        info.cbSize = sizeof(info);
+        info.fMask  = SEE_MASK_NOCLOSEPROCESS;
+        info.lpVerb = "runas";
+        info.lpFile = script.c_str();
+        info.nShow  = SW_SHOWNORMAL;
+        if (!ShellExecuteExA(&info) || !info.hProcess)
+            return nullptr;
+
+        if (!apply_process_options(info.hProcess, options))
+            Logger::error("Scheduling options not applied, {} runs with the defaults!", script);
+        return info.hProcess;
+    }
+
+    // started suspended, nothing runs before the options apply
+    std::string command = "cmd.exe /c \"\"" + script + "\"\"";
+
+    STARTUPINFOA        startup{};
+    PROCESS_INFORMATION process{};
+    startup.cb = sizeof(startup);
+    if (!CreateProcessA(NULL, &command[0], NULL, NULL, FALSE, CREATE_SUSPENDED | CREATE_NEW_CONSOLE, NULL, NULL, &startup, &process))
+        return nullptr;
+
+    // never run the app with scheduling it was not configured for
+    if (!apply_process_options(process.hProcess, options)) {
+        Logger::error("Scheduling options not applied, {} not started!", script);
+        TerminateProcess(process.hProcess, 1);
+        CloseHandle(process.hThread);
+        CloseHandle(process.hProcess);
+        return nullptr;
+    }
+
+    ResumeThread(process.hThread);
+    CloseHandle(process.hThread);
+    return process.hProcess;
+}
+
+bool AppLauncher::launch()
+{
+    Logger::info("Launch {}", name);
+
+    prepare();
+
+    // start the app on the final desktop layout, not mid mode change
+    display_topology().settle();
+
+    launches.add();
+    if (!execute()) {
+        launch_failures.add();
+        return false;
+    }
+    return true;
+}
+
+void AppLauncher::prepare()
+{
+    auto configpath = std::filesystem::path(get_app_config_path(APP_NAME).value());
+    auto scriptfile = configpath / script;
+    Logger::info("script: {}", scriptfile.string());
+
+    std::ofstream of(scriptfile, std::ios::out);
+    of << commands;
+    of.close();
+
+    script = scriptfile.string();
+}
+
+bool AppLauncher::execute()
+{
+    Logger::info("script {}", script);
+
+    // scheduling options need the process handle
+    if (!process.empty()) {
+        HANDLE handle = spawn_process(script, elevated, process);
+        if (!handle) {
+            Logger::error("Failed to execute command!");
+            return false;
+        }
+        CloseHandle(handle);
+        Logger::info("Command executed successfully!");
+        return true;
+    }
+
+    HINSTANCE result = ShellExecuteA(
+        nullptr,
+        elevated ? "runas" : "open",
+        script.c_str(),
+        NULL,
+        NULL,
+        SW_SHOWNORMAL);
+
+    if ((long long)(result) <= 32) {
+        Logger::error("Failed to execute command!");
+        return false;
+    }
+
+    Logger::info("Command executed successfully!");
+    return true;
+}
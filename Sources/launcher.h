@@ -0,0 +1,55 @@
+#ifndef LAUNCHER_H
+#define LAUNCHER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <Windows.h>
+
+// Scheduling of the launched process, inherited by the processes it starts.
+struct ProcessOptions
+{
+    uint64_t affinity       = 0;  // cores the app may run on, all cores when 0
+    uint64_t reserved       = 0;  // cores kept free for Sunshine's capture and encoder
+    DWORD    priority_class = 0;  // unchanged when 0
+    int      io_priority    = -1; // 0 very low to 3 high, unchanged when < 0
+
+    bool empty() const { return !affinity && !reserved && !priority_class && io_priority < 0; }
+};
+
+// idle, below_normal, normal, above_normal, high
+bool set_priority_class(ProcessOptions& options, const std::string& name);
+
+// very_low, low, normal, high
+bool set_io_priority(ProcessOptions& options, const std::string& name);
+
+// affinity without the reserved cores, limited to `system`, 0 when nothing is left
+uint64_t effective_affinity(const ProcessOptions& options, uint64_t system);
+
+// batch file name for an app, characters not allowed in file names replaced
+std::string script_name(const std::string& name);
+
+// run `script` through cmd.exe with `options` applied before it runs,
+// the process handle or nullptr, also when the options cannot be applied
+HANDLE spawn_process(const std::string& script, bool elevated, const ProcessOptions& options);
+
+// Launches an application through a generated batch script.
+struct AppLauncher
+{
+    std::string              name     = "";
+    std::string              script   = "";
+    bool                     elevated = false;
+    std::string              commands = "";
+    ProcessOptions           process{};
+    std::vector<std::string> prefetch{}; // executable and warm-up files read ahead on selection
+    std::string              cover = "";  // image shown in the grid view
+
+    bool launch();
+
+    void prepare();
+
+    bool execute();
+};
+
+#endif // LAUNCHER_H
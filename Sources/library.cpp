@@ -0,0 +1,323 @@
+#include <tuple>
+#include <chrono>
+#include <future>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#define TOML_EXCEPTIONS 0
+#include <toml++/toml.hpp>
+
+#include "path.h"
+#include "logger.h"
+#include "library.h"
+#include "timeline.h"
+
+// Steamworks Common Redistributables, installed with every library but not a game
+static constexpr std::string_view STEAM_REDIST_APPID = "228980";
+
+static std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+// quoted tokens of one VDF line, e.g. "appid"		"570"
+static std::vector<std::string> vdf_tokens(std::string_view line)
+{
+    std::vector<std::string> tokens{};
+    for (size_t i = 0; i < line.size(); i++) {
+        if (line[i] != '"')
+            continue;
+
+        std::string token{};
+        for (i++; i < line.size() && line[i] != '"'; i++) {
+            if (line[i] == '\\' && i + 1 < line.size())
+                i++;
+            token += line[i];
+        }
+        tokens.push_back(std::move(token));
+    }
+    return tokens;
+}
+
+template <typename Callback>
+static void for_each_vdf_pair(std::string_view content, Callback callback)
+{
+    size_t begin = 0;
+    while (begin < content.size()) {
+        size_t end = content.find('\n', begin);
+        if (end == std::string_view::npos)
+            end = content.size();
+
+        auto tokens = vdf_tokens(content.substr(begin, end - begin));
+        if (tokens.size() == 2)
+            callback(tokens[0], tokens[1]);
+        begin = end + 1;
+    }
+}
+
+bool parse_app_manifest(std::string_view content, std::string& appid, std::string& name)
+{
+    appid.clear();
+    name.clear();
+
+    // first occurrence, both are at the top level of AppState
+    for_each_vdf_pair(content, [&](const std::string& key, const std::string& value) {
+        if (key == "appid" && appid.empty())
+            appid = value;
+        else if (key == "name" && name.empty())
+            name = value;
+    });
+    return !appid.empty() && !name.empty();
+}
+
+std::vector<std::string> parse_library_folders(std::string_view content)
+{
+    std::vector<std::string> folders{};
+    for_each_vdf_pair(content, [&](const std::string& key, const std::string& value) {
+        if (key == "path")
+            folders.push_back(value);
+    });
+    return folders;
+}
+
+static bool has_extension(const std::filesystem::path& path, std::initializer_list<const char*> extensions)
+{
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return std::any_of(extensions.begin(), extensions.end(), [&](const char* e) { return extension == e; });
+}
+
+// first of the candidates that exists, empty when there is none
+static std::string find_cover(std::initializer_list<std::filesystem::path> candidates)
+{
+    std::error_code ec;
+    for (const auto& candidate : candidates) {
+        if (std::filesystem::is_regular_file(candidate, ec))
+            return candidate.string();
+    }
+    return "";
+}
+
+LibraryDirectory scan_library_directory(const std::string& type, const std::string& path, const std::vector<LibraryDirectory>& cache,
+    const std::string& art)
+{
+    LibraryDirectory directory{type, path};
+
+    std::error_code ec;
+    auto            mtime = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return directory;
+    directory.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+    // files were neither added, removed nor renamed since the last scan
+    auto it = std::find_if(cache.begin(), cache.end(), [&](const LibraryDirectory& cached) {
+        return cached.type == type && cached.path == path && cached.mtime == directory.mtime;
+    });
+    if (it != cache.end())
+        return *it;
+
+    for (auto entry = std::filesystem::directory_iterator(path, ec); !ec && entry != std::filesystem::directory_iterator(); entry.increment(ec)) {
+        const auto& file     = entry->path();
+        std::string filename = file.filename().string();
+
+        if (type == "steam") {
+            if (filename.rfind("appmanifest_", 0) != 0 || !has_extension(file, {".acf"}))
+                continue;
+
+            std::string appid, name;
+            if (!parse_app_manifest(read_file(file), appid, name) || appid == STEAM_REDIST_APPID)
+                continue;
+            // portrait capsule, flat in older clients and per appid in newer ones
+            std::string cover = art.empty() ? "" : find_cover({
+                std::filesystem::path(art) / (appid + "_library_600x900.jpg"),
+                std::filesystem::path(art) / appid / "library_600x900.jpg",
+            });
+            directory.entries.push_back({name, "start \"\" \"steam://rungameid/" + appid + "\"\n", cover});
+        } else if (type == "folder") {
+            if (!entry->is_regular_file(ec) || !has_extension(file, {".lnk", ".url", ".exe"}))
+                continue;
+            // an image next to the shortcut with the same name
+            auto cover = find_cover({
+                std::filesystem::path(file).replace_extension(".png"),
+                std::filesystem::path(file).replace_extension(".jpg"),
+            });
+            directory.entries.push_back({file.stem().string(), "start \"\" \"" + file.string() + "\"\n", cover});
+        }
+    }
+
+    std::sort(directory.entries.begin(), directory.entries.end(),
+        [](const LibraryDirectory::Entry& a, const LibraryDirectory::Entry& b) { return a.name < b.name; });
+    return directory;
+}
+
+// ---------------------------------------------------------------------------
+
+static std::vector<LibraryDirectory> load_library_cache(const std::filesystem::path& path)
+{
+    std::vector<LibraryDirectory> cache{};
+    if (!std::filesystem::exists(path))
+        return cache;
+
+    toml::parse_result result = toml::parse_file(path.string());
+    if (!result) {
+        Logger::error("Failed to parse library cache {}, rescanning!", path.string());
+        return cache;
+    }
+
+    toml::table table = std::move(result).table();
+    if (auto* directories = table["directories"].as_array()) {
+        for (auto& elem : *directories) {
+            auto* item = elem.as_table();
+            if (!item)
+                continue;
+
+            LibraryDirectory directory{};
+            directory.type  = (*item)["type"].value_or<std::string>("");
+            directory.path  = (*item)["path"].value_or<std::string>("");
+            directory.mtime = (*item)["mtime"].value_or<int64_t>(0);
+            if (auto* entries = (*item)["entries"].as_array()) {
+                for (auto& entry : *entries) {
+                    if (auto* e = entry.as_table())
+                        directory.entries.push_back({
+                            (*e)["name"].value_or<std::string>(""),
+                            (*e)["commands"].value_or<std::string>(""),
+                            (*e)["cover"].value_or<std::string>(""),
+                        });
+                }
+            }
+            cache.push_back(std::move(directory));
+        }
+    }
+    return cache;
+}
+
+static void save_library_cache(const std::filesystem::path& path, const std::vector<LibraryDirectory>& cache)
+{
+    toml::array directories{};
+    for (const auto& directory : cache) {
+        toml::array entries{};
+        for (const auto& entry : directory.entries)
+            entries.push_back(toml::table{{"name", entry.name}, {"commands", entry.commands}, {"cover", entry.cover}});
+
+        directories.push_back(toml::table{
+            {"type", directory.type},
+            {"path", directory.path},
+            {"mtime", directory.mtime},
+            {"entries", std::move(entries)},
+        });
+    }
+
+    toml::table table{};
+    table.insert("directories", std::move(directories));
+
+    std::stringstream ss;
+    ss << table << "\n";
+    if (!write_file_atomic(path, ss.str()))
+        Logger::error("Failed to write library cache to {} ({})!", path.string(), GetLastError());
+}
+
+std::vector<AppLauncher> load_library_apps(const std::filesystem::path& cache_path)
+{
+    std::vector<AppLauncher> apps{};
+    for (const auto& directory : load_library_cache(cache_path)) {
+        for (const auto& entry : directory.entries)
+            apps.push_back(AppLauncher{entry.name, script_name(entry.name), false, entry.commands, {}, {}, entry.cover});
+    }
+    return apps;
+}
+
+LibraryImporter::~LibraryImporter()
+{
+    join();
+}
+
+void LibraryImporter::start(const std::vector<LibrarySource>& sources, const std::filesystem::path& cache_path)
+{
+    join();
+    if (sources.empty())
+        return;
+
+    finished = false;
+    thread   = std::thread(&LibraryImporter::run, this, sources, cache_path);
+}
+
+std::vector<AppLauncher> LibraryImporter::poll()
+{
+    std::vector<AppLauncher> apps{};
+
+    std::lock_guard<std::mutex> lock(mutex);
+    apps.swap(pending);
+    return apps;
+}
+
+void LibraryImporter::join()
+{
+    if (thread.joinable())
+        thread.join();
+}
+
+void LibraryImporter::run(std::vector<LibrarySource> sources, std::filesystem::path cache_path)
+{
+    auto trace = timeline().scope("library scan");
+
+    auto begin = std::chrono::steady_clock::now();
+    auto cache = load_library_cache(cache_path);
+
+    // a Steam install lists its other library folders, covers of all of them are in the install
+    std::vector<std::tuple<std::string, std::string, std::string>> folders{};
+    for (const auto& source : sources) {
+        if (source.type == "steam") {
+            auto steamapps = std::filesystem::path(source.path) / "steamapps";
+            auto art       = (std::filesystem::path(source.path) / "appcache" / "librarycache").string();
+            folders.emplace_back(source.type, steamapps.string(), art);
+            for (const auto& folder : parse_library_folders(read_file(steamapps / "libraryfolders.vdf")))
+                folders.emplace_back(source.type, (std::filesystem::path(folder) / "steamapps").string(), art);
+        } else {
+            folders.emplace_back(source.type, source.path, "");
+        }
+    }
+    std::sort(folders.begin(), folders.end());
+    folders.erase(std::unique(folders.begin(), folders.end()), folders.end());
+
+    // one task per directory, apps are handed out as each one completes
+    std::vector<std::future<LibraryDirectory>> tasks{};
+    for (const auto& [type, path, art] : folders) {
+        tasks.push_back(std::async(std::launch::async, [this, &cache, type = type, path = path, art = art]() {
+            LibraryDirectory directory = scan_library_directory(type, path, cache, art);
+            Logger::debug("Scanned {} library folder {} ({} apps)", type, path, directory.entries.size());
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& entry : directory.entries)
+                pending.push_back(AppLauncher{entry.name, script_name(entry.name), false, entry.commands, {}, {}, entry.cover});
+            return directory;
+        }));
+    }
+
+    std::vector<LibraryDirectory> scanned{};
+    for (auto& task : tasks) {
+        scanned.push_back(task.get());
+        directories++;
+
+        const auto& directory = scanned.back();
+        if (std::any_of(cache.begin(), cache.end(), [&](const LibraryDirectory& c) {
+                return c.type == directory.type && c.path == directory.path && c.mtime == directory.mtime;
+            }))
+            cached++;
+    }
+
+    size_t apps = 0;
+    for (const auto& directory : scanned)
+        apps += directory.entries.size();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+    Logger::info("Imported {} apps from {} library folders ({} unchanged) in {} ms", apps, scanned.size(), cached.load(), elapsed);
+
+    // rewritten when a directory changed, appeared or went away
+    if (cached < scanned.size() || cache.size() != scanned.size())
+        save_library_cache(cache_path, scanned);
+    finished = true;
+}
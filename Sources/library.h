@@ -0,0 +1,80 @@
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "launcher.h"
+
+// Where installed games are imported from, [[libraries]] in the config.
+struct LibrarySource
+{
+    std::string type = ""; // steam (install folder) or folder (shortcuts and executables)
+    std::string path = "";
+};
+
+// Apps found in one directory, reused while the directory's mtime is unchanged.
+struct LibraryDirectory
+{
+    struct Entry
+    {
+        std::string name     = "";
+        std::string commands = "";
+        std::string cover    = "";
+    };
+
+    std::string        type  = "";
+    std::string        path  = "";
+    int64_t            mtime = 0;
+    std::vector<Entry> entries{};
+};
+
+// "appid" and "name" of a Steam appmanifest_*.acf
+bool parse_app_manifest(std::string_view content, std::string& appid, std::string& name);
+
+// library folders listed in Steam's libraryfolders.vdf
+std::vector<std::string> parse_library_folders(std::string_view content);
+
+// scan one directory, or take its cached entries when the mtime matches,
+// `art` is Steam's librarycache folder holding the cover of each appid
+LibraryDirectory scan_library_directory(const std::string& type, const std::string& path, const std::vector<LibraryDirectory>& cache,
+    const std::string& art = "");
+
+// apps of the last scan as kept in `cache_path`, without scanning
+std::vector<AppLauncher> load_library_apps(const std::filesystem::path& cache_path);
+
+// Scans library directories in parallel, apps are handed out as directories complete.
+struct LibraryImporter
+{
+    ~LibraryImporter();
+
+    // `cache_path` holds the last scan, rewritten when the scan is done
+    void start(const std::vector<LibrarySource>& sources, const std::filesystem::path& cache_path);
+
+    // apps found since the last call
+    std::vector<AppLauncher> poll();
+
+    // wait for the scan to finish
+    void join();
+
+    bool done() const { return finished; }
+
+    std::atomic<uint64_t> directories{0}; // scanned
+    std::atomic<uint64_t> cached{0};      // of which unchanged since the last scan
+
+private:
+    void run(std::vector<LibrarySource> sources, std::filesystem::path cache_path);
+
+    std::mutex               mutex{};
+    std::vector<AppLauncher> pending{};
+    std::thread              thread{};
+    std::atomic<bool>        finished{true};
+};
+
+#endif // LIBRARY_H
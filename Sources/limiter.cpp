@@ -0,0 +1,68 @@
+#include <thread>
+
+#include <Windows.h>
+
+#include "limiter.h"
+
+// Windows 10 1803 and later, older SDKs lack the define
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+FrameLimiter::~FrameLimiter()
+{
+    stop();
+}
+
+void FrameLimiter::start(int fps)
+{
+    stop();
+    if (fps <= 0)
+        return;
+
+    // a high-resolution timer wakes within ~0.5 ms, a plain one only at the next scheduler tick
+    timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    spin  = std::chrono::microseconds(timer ? 500 : 2000);
+    if (!timer)
+        timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+
+    period   = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    deadline = Clock::now();
+}
+
+void FrameLimiter::stop()
+{
+    if (timer)
+        CloseHandle(timer);
+    timer  = nullptr;
+    period = Clock::duration::zero();
+}
+
+void FrameLimiter::wait()
+{
+    if (!active())
+        return;
+
+    deadline += period;
+
+    auto now = Clock::now();
+    if (now >= deadline) {
+        missed++;
+        deadline = now;
+        return;
+    }
+
+    // relative due time in 100 ns units
+    auto sleep = deadline - now - spin;
+    if (sleep > Clock::duration::zero()) {
+        LARGE_INTEGER due{};
+        due.QuadPart = -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(sleep).count();
+        if (timer && SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE))
+            WaitForSingleObject(timer, INFINITE);
+        else
+            std::this_thread::sleep_for(sleep);
+    }
+
+    while (Clock::now() < deadline)
+        YieldProcessor();
+}
@@ -0,0 +1,37 @@
+#ifndef LIMITER_H
+#define LIMITER_H
+
+#include <chrono>
+#include <cstdint>
+
+// Paces frames to a fixed rate when vsync is off. Sleeps on a high-resolution
+// waitable timer until shortly before the deadline and spins the rest.
+struct FrameLimiter
+{
+    using Clock = std::chrono::steady_clock;
+
+    ~FrameLimiter();
+
+    // pace to `fps` frames per second from now on
+    void start(int fps);
+
+    void stop();
+
+    // block until the next deadline, a missed one restarts the pacing from now
+    void wait();
+
+    // the next deadline is a period from now, after a frame paced by something else
+    void restart() { deadline = Clock::now(); }
+
+    bool active() const { return period.count() > 0; }
+
+    Clock::duration   period{};
+    Clock::duration   spin{};     // spun instead of slept, covers the timer's wake-up jitter
+    Clock::time_point deadline{};
+    uint64_t          missed = 0; // deadlines passed before wait() was called
+
+private:
+    void* timer = nullptr; // waitable timer HANDLE
+};
+
+#endif // LIMITER_H
@@ -1,49 +1,61 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <mutex>
 #include <spdlog/spdlog.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
-struct RingBufferSink : public spdlog::sinks::sink
+#include "metrics.h"
+
+// Keeps the last `capacity` messages for the logs tab. Loggers on any thread write
+// into it, the UI reads it through visit() under the same lock.
+struct RingBufferSink : public spdlog::sinks::base_sink<std::mutex>
 {
 public:
     explicit RingBufferSink(size_t capacity) : capacity(capacity) {}
 
-    void log(const spdlog::details::log_msg& msg) override
-    {
-        std::string message = fmt::to_string(msg.payload);
-        if (buffer.size() < capacity) {
-            buffer.push_back(message);
-        } else {
-            buffer[index] = message; // overwrite oldest message
-            index         = (index + 1) % capacity;
-        }
-    }
-
-    void flush() override
+    // calls `f` with each message, oldest first, under the sink's lock (`f` must not log)
+    template <typename F>
+    void visit(F&& f)
     {
-        // Do nothing because statement executed in sink_it_().
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < buffer.size(); i++)
+            f(buffer[(index + i) % buffer.size()]);
     }
 
-    void set_pattern(const std::string& pattern) override
+    // copy of the messages, oldest first
+    std::vector<std::string> logs()
     {
-        // Don't format log message.
+        std::vector<std::string> copy{};
+        visit([&](const std::string& message) { copy.push_back(message); });
+        return copy;
     }
 
-    void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override
     {
-        // Don't format log message.
+        // unformatted, the tab shows the payload only
+        std::string message = fmt::to_string(msg.payload);
+        if (buffer.size() < capacity) {
+            buffer.push_back(std::move(message));
+        } else {
+            buffer[index] = std::move(message); // overwrite oldest message
+            index         = (index + 1) % capacity;
+            dropped.add();
+        }
     }
 
-    const auto& logs() const
+    void flush_() override
     {
-        return buffer;
+        // Do nothing because messages are kept in memory.
     }
 
 private:
     size_t                   capacity = 0;
-    size_t                   index    = 0;
+    size_t                   index    = 0; // oldest message once the buffer is full
     std::vector<std::string> buffer;
+    Counter&                 dropped  = metrics().counter("launcher_log_dropped", "Log messages overwritten in the logs tab buffer");
 };
 
 struct Logger
@@ -61,22 +73,47 @@ struct Logger
         return Logger::logger;
     }
 
+    // below SPDLOG_ACTIVE_LEVEL calls compile to nothing, format strings are checked at compile time
     template <typename... Args>
-    static void info(const char* fmt, Args&&... args)
+    static void trace(spdlog::format_string_t<Args...> fmt, Args&&... args)
     {
-        Logger::logger->info(fmt, std::forward<Args>(args)...);
+        log<SPDLOG_LEVEL_TRACE>(fmt, std::forward<Args>(args)...);
     }
 
     template <typename... Args>
-    static void warn(const char* fmt, Args&&... args)
+    static void debug(spdlog::format_string_t<Args...> fmt, Args&&... args)
     {
-        Logger::logger->warn(fmt, std::forward<Args>(args)...);
+        log<SPDLOG_LEVEL_DEBUG>(fmt, std::forward<Args>(args)...);
     }
 
     template <typename... Args>
-    static void error(const char* fmt, Args&&... args)
+    static void info(spdlog::format_string_t<Args...> fmt, Args&&... args)
     {
-        Logger::logger->error(fmt, std::forward<Args>(args)...);
+        log<SPDLOG_LEVEL_INFO>(fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    static void warn(spdlog::format_string_t<Args...> fmt, Args&&... args)
+    {
+        log<SPDLOG_LEVEL_WARN>(fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    static void error(spdlog::format_string_t<Args...> fmt, Args&&... args)
+    {
+        log<SPDLOG_LEVEL_ERROR>(fmt, std::forward<Args>(args)...);
+    }
+
+private:
+    template <int level, typename... Args>
+    static void log(spdlog::format_string_t<Args...> fmt, Args&&... args)
+    {
+        if constexpr (level >= SPDLOG_ACTIVE_LEVEL) {
+            Logger::logger->log(static_cast<spdlog::level::level_enum>(level), fmt, std::forward<Args>(args)...);
+        } else {
+            (void)fmt;
+            ((void)args, ...);
+        }
     }
 };
 
@@ -0,0 +1,181 @@
+#include <limits>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+
+#include <Windows.h>
+
+#include "path.h"
+#include "logger.h"
+#include "metrics.h"
+
+Histogram::Histogram(std::initializer_list<double> bounds)
+{
+    size = std::min(bounds.size(), max_bounds);
+    std::copy_n(bounds.begin(), size, this->bounds.begin());
+}
+
+void Histogram::observe(double value)
+{
+    size_t i = std::lower_bound(bounds.begin(), bounds.begin() + size, value) - bounds.begin();
+    buckets[i].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::bucket(size_t i) const
+{
+    uint64_t count = 0;
+    for (size_t j = 0; j <= i && j <= size; j++)
+        count += buckets[j].load(std::memory_order_relaxed);
+    return count;
+}
+
+uint64_t Histogram::count() const
+{
+    return bucket(size);
+}
+
+double Histogram::estimate(double quantile) const
+{
+    uint64_t total = count();
+    if (total == 0)
+        return 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(quantile * total);
+    for (size_t i = 0; i < size; i++) {
+        if (bucket(i) > rank)
+            return bounds[i];
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+// ---------------------------------------------------------------------------
+
+Metrics::~Metrics()
+{
+    stop();
+}
+
+Counter& Metrics::counter(const char* name, const char* help)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : entries) {
+        if (entry.type == CounterType && std::strcmp(entry.name, name) == 0)
+            return *static_cast<Counter*>(entry.metric);
+    }
+    entries.push_back(Entry{CounterType, name, help, &counters.emplace_back()});
+    return counters.back();
+}
+
+Gauge& Metrics::gauge(const char* name, const char* help)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : entries) {
+        if (entry.type == GaugeType && std::strcmp(entry.name, name) == 0)
+            return *static_cast<Gauge*>(entry.metric);
+    }
+    entries.push_back(Entry{GaugeType, name, help, &gauges.emplace_back()});
+    return gauges.back();
+}
+
+Histogram& Metrics::histogram(const char* name, const char* help, std::initializer_list<double> bounds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : entries) {
+        if (entry.type == HistogramType && std::strcmp(entry.name, name) == 0)
+            return *static_cast<Histogram*>(entry.metric);
+    }
+    entries.push_back(Entry{HistogramType, name, help, &histograms.emplace_back(bounds)});
+    return histograms.back();
+}
+
+std::string Metrics::text() const
+{
+    std::stringstream ss;
+    ss.precision(9);
+
+    // counters are typed with the _total suffix, as the textfile collector's parser expects
+    visit([&](const Entry& entry) {
+        switch (entry.type) {
+        case CounterType:
+            ss << "# HELP " << entry.name << "_total " << entry.help << "\n";
+            ss << "# TYPE " << entry.name << "_total counter\n";
+            ss << entry.name << "_total " << static_cast<const Counter*>(entry.metric)->get() << "\n";
+            break;
+        case GaugeType:
+            ss << "# HELP " << entry.name << " " << entry.help << "\n";
+            ss << "# TYPE " << entry.name << " gauge\n";
+            ss << entry.name << " " << static_cast<const Gauge*>(entry.metric)->get() << "\n";
+            break;
+        case HistogramType: {
+            const auto& histogram = *static_cast<const Histogram*>(entry.metric);
+            ss << "# HELP " << entry.name << " " << entry.help << "\n";
+            ss << "# TYPE " << entry.name << " histogram\n";
+            for (size_t i = 0; i < histogram.size; i++)
+                ss << entry.name << "_bucket{le=\"" << histogram.bounds[i] << "\"} " << histogram.bucket(i) << "\n";
+            ss << entry.name << "_bucket{le=\"+Inf\"} " << histogram.count() << "\n";
+            ss << entry.name << "_sum " << histogram.sum() << "\n";
+            ss << entry.name << "_count " << histogram.count() << "\n";
+            break;
+        }
+        }
+    });
+    ss << "# EOF\n";
+    return ss.str();
+}
+
+bool Metrics::save(const std::string& path) const
+{
+    // written aside and renamed, the collector never reads a partial file
+    if (!write_file_atomic(path, text())) {
+        Logger::error("Failed to write metrics to {} ({})!", path, GetLastError());
+        return false;
+    }
+    return true;
+}
+
+void Metrics::start(std::string path, std::chrono::seconds interval)
+{
+    stop();
+
+    this->path     = std::move(path);
+    this->interval = interval;
+    thread         = std::thread(&Metrics::run, this);
+    Logger::info("Exporting metrics to {} every {} s", this->path, interval.count());
+}
+
+void Metrics::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    woken.notify_all();
+    thread.join();
+    stopping = false;
+}
+
+void Metrics::run()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            woken.wait_for(lock, interval, [this]() { return stopping; });
+            if (stopping)
+                break;
+        }
+        save(path);
+    }
+
+    // final values, e.g. the launch right before the window closed
+    save(path);
+}
+
+Metrics& metrics()
+{
+    static Metrics metrics{};
+    return metrics;
+}
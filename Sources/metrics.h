@@ -0,0 +1,126 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <mutex>
+#include <array>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
+#include <condition_variable>
+
+// Counters, gauges and histograms are relaxed atomics on their own cache line,
+// threads updating different metrics never write to the same line.
+struct alignas(64) Counter
+{
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+    std::atomic<uint64_t> value{0};
+};
+
+struct alignas(64) Gauge
+{
+    void set(int64_t v) { value.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+
+    int64_t get() const { return value.load(std::memory_order_relaxed); }
+
+    std::atomic<int64_t> value{0};
+};
+
+// Observations counted into fixed buckets, upper bounds ascending, +Inf implied.
+struct alignas(64) Histogram
+{
+    static constexpr size_t max_bounds = 15;
+
+    explicit Histogram(std::initializer_list<double> bounds);
+
+    void observe(double value);
+
+    // observations <= bounds[i], the last bucket is +Inf
+    uint64_t bucket(size_t i) const;
+    uint64_t count() const;
+    double   sum() const { return total.load(std::memory_order_relaxed); }
+
+    // upper bound of the bucket holding `quantile` of the observations, for display
+    double estimate(double quantile) const;
+
+    std::array<double, max_bounds> bounds{};
+    size_t                         size = 0; // used bounds
+
+private:
+    std::array<std::atomic<uint64_t>, max_bounds + 1> buckets{}; // not cumulative
+    std::atomic<double>                               total{0.0};
+};
+
+// Process-wide set of named metrics, exported as an OpenMetrics text file.
+// Metrics are registered once (typically as statics) and never removed.
+struct Metrics
+{
+    enum Type
+    {
+        CounterType,
+        GaugeType,
+        HistogramType,
+    };
+
+    struct Entry
+    {
+        Type        type   = CounterType;
+        const char* name   = ""; // string literals, [a-z_] without the _total suffix
+        const char* help   = "";
+        void*       metric = nullptr; // Counter, Gauge or Histogram
+    };
+
+    ~Metrics();
+
+    // the metric registered as `name`, created on first use
+    Counter&   counter(const char* name, const char* help);
+    Gauge&     gauge(const char* name, const char* help);
+    Histogram& histogram(const char* name, const char* help, std::initializer_list<double> bounds);
+
+    // calls `f` with each entry in registration order, under the registry lock
+    template <typename F>
+    void visit(F&& f) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& entry : entries)
+            f(entry);
+    }
+
+    // all metrics in the text exposition format, ends with # EOF
+    std::string text() const;
+
+    // write text() to `path` every `interval` and once more on stop()
+    void start(std::string path, std::chrono::seconds interval);
+    void stop();
+
+    bool save(const std::string& path) const;
+
+private:
+    void run();
+
+    mutable std::mutex    mutex{};
+    std::deque<Counter>   counters{};
+    std::deque<Gauge>     gauges{};
+    std::deque<Histogram> histograms{};
+    std::vector<Entry>    entries{};
+
+    // periodic export
+    std::condition_variable woken{};
+    std::thread             thread{};
+    std::string             path     = "";
+    std::chrono::seconds    interval = std::chrono::seconds(15);
+    bool                    stopping = false;
+};
+
+// process-wide registry
+Metrics& metrics();
+
+#endif // METRICS_H
@@ -0,0 +1,1015 @@
+#include <optional>
+#include <algorithm>
+#include <imgui.h>
+#include <filesystem>
+
+#include "path.h"
+#include "font.h"
+#include "logger.h"
+#include "config.h"
+#include "metrics.h"
+#include "session.h"
+#include "timeline.h"
+#include "myapp.h"
+
+const char* display_label(FrameArena& arena, const DisplaySettings& settings)
+{
+    const char* label = arena.format(" %s %dx%d@%d Hz", ICON_FA_LAPTOP, settings.width, settings.height, settings.frequency);
+    if (!settings.name.empty())
+        label = arena.format("%s (%s)", label, settings.name.c_str());
+    for (size_t i = 0; i < settings.monitors.size(); i++)
+        label = arena.format("%s%s%s%s", label, i == 0 ? " [" : ", ", settings.monitors[i].c_str(), i + 1 == settings.monitors.size() ? "]" : "");
+    return label;
+}
+
+const char* launcher_label(FrameArena& arena, const AppLauncher& launcher)
+{
+    return arena.format(" %s %s", ICON_FA_CUBE, launcher.name.c_str());
+}
+
+void MyApp::fit(uint width, uint height, uint frequency)
+{
+    auto trace = timeline().scope("MyApp::fit");
+
+    const DisplaySettings* display = find_display_settings(preset_display_settings, width, height);
+    if (!display)
+        display = find_display_settings(supported_display_settings, width, height);
+    if (!display) {
+        display = fitter.best(width, height, frequency);
+        if (!display)
+            return;
+        Logger::info("No {}x{} mode, closest is {}x{}@{} Hz", width, height, display->width, display->height, display->frequency);
+    }
+
+    apply_display_settings(*display);
+    applied = *display;
+}
+
+bool MyApp::auto_launch(int confidence)
+{
+    auto trace = timeline().scope("MyApp::auto_launch");
+
+    // before any window, only what the decision needs: profiles first, then the config
+    auto app_config_path = get_app_config_path(APP_NAME);
+    if (client.empty() || !app_config_path.has_value())
+        return false;
+    auto config_path = std::filesystem::path(app_config_path.value());
+
+    profiles.load(config_path / "profiles.toml");
+    const ClientProfile* profile = profiles.find(client);
+    if (!profile || profile->hits < confidence)
+        return false;
+
+    Config config{};
+    if (!load_config(config_path / "moonlight-launcher.toml", config))
+        return false;
+
+    // the preset or app may have been removed from the config since,
+    // supported modes are only enumerated when no preset matches
+    const DisplaySettings* display = find_display_settings(config.display_settings, profile->width, profile->height);
+    if (!display) {
+        supported_display_settings = list_display_settings();
+        display                    = find_display_settings(supported_display_settings, profile->width, profile->height);
+    }
+
+    // imported apps as of the last library scan, no rescan
+    auto find_app = [&](const std::vector<AppLauncher>& launchers) {
+        auto it = std::find_if(launchers.begin(), launchers.end(), [&](const AppLauncher& launcher) { return launcher.name == profile->app; });
+        return it != launchers.end() ? std::optional<AppLauncher>(*it) : std::nullopt;
+    };
+    auto launcher = find_app(config.application_launchers);
+    if (!launcher && !config.libraries.empty())
+        launcher = find_app(load_library_apps(config_path / "library.toml"));
+    if (!display || !launcher)
+        return false;
+
+    Logger::info("Profile of {} seen {} times, launching {} without UI", client, profile->hits, profile->app);
+
+    // the listener lets the launch wait for the new mode to settle
+    display_topology().watch();
+
+    DisplaySettings settings = *display;
+    settings.frequency       = profile->frequency;
+    settings.scale           = profile->scale;
+    apply_display_settings(settings);
+    applied = settings;
+
+    remember(launcher->name);
+    bool launched = launcher->launch();
+    display_topology().stop();
+
+    // no exporter runs without the UI, one export keeps the mode switch and the launch
+    if (!config.metrics_path.empty())
+        metrics().save(config.metrics_path);
+
+    if (!launched)
+        exit(1);
+    return true;
+}
+
+void MyApp::remember(const std::string& app)
+{
+    auto app_config_path = get_app_config_path(APP_NAME);
+    if (client.empty() || applied.width <= 0 || !app_config_path.has_value())
+        return;
+
+    ClientProfile session{};
+    session.client    = client;
+    session.width     = applied.width;
+    session.height    = applied.height;
+    session.frequency = applied.frequency;
+    session.scale     = applied.scale;
+    session.app       = app;
+
+    const ClientProfile& profile = profiles.record(session);
+    Logger::info("Profile of {}: {} at {}x{}, {} in a row", client, app, profile.width, profile.height, profile.hits);
+    profiles.save(std::filesystem::path(app_config_path.value()) / "profiles.toml");
+}
+
+void MyApp::import_apps()
+{
+    auto apps = library.poll();
+    if (apps.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(launchers_mutex);
+    for (auto& app : apps) {
+        auto it = std::find_if(application_launchers.begin(), application_launchers.end(),
+            [&](const AppLauncher& launcher) { return launcher.name == app.name; });
+        if (it == application_launchers.end()) {
+            grid |= !grid_toggled && !app.cover.empty();
+            application_launchers.push_back(std::move(app));
+        }
+    }
+}
+
+void MyApp::init()
+{
+    auto trace = timeline().scope("MyApp::init");
+    init_modes();
+    init_config();
+}
+
+void MyApp::init_modes()
+{
+    // display settings, topology is cached until the next display change
+    auto trace = timeline().scope("list_display_settings");
+    display_topology().watch();
+    supported_display_settings = list_display_settings();
+    fitter.reset(supported_display_settings);
+}
+
+void MyApp::init_config()
+{
+    auto app_config_path = get_app_config_path(APP_NAME);
+    if (!app_config_path.has_value()) {
+        Logger::info("Config director is not available!");
+        return;
+    }
+
+    // create config directory is necessary
+    if (!std::filesystem::exists(app_config_path.value())) {
+        std::filesystem::create_directory(app_config_path.value());
+    }
+
+    // read config file
+    auto config_path = std::filesystem::path(app_config_path.value());
+    auto config_file = config_path / "moonlight-launcher.toml";
+    Logger::info("Loading configuration file at:");
+    Logger::info("{}", config_file.string());
+    if (!std::filesystem::exists(config_file)) {
+        Logger::info("Toml config file does not exist!");
+        Logger::info("Creating default config file!");
+        create_default_config_file(config_file);
+    }
+
+    Config config{};
+    {
+        auto scope = timeline().scope("load_config");
+        if (!load_config(config_file, config))
+            return;
+    }
+
+    preset_display_settings = std::move(config.display_settings);
+    gamepad_profiles        = std::move(config.gamepad_profiles);
+    {
+        // the list is only written under the lock, the control pipe's Launch reads it
+        // while import_apps() appends library results on the UI thread
+        std::lock_guard<std::mutex> lock(launchers_mutex);
+        application_launchers = std::move(config.application_launchers);
+    }
+
+    // covers switch the launcher to the grid view
+    cover_budget = static_cast<size_t>(config.cover_budget) << 20;
+    grid         = std::any_of(application_launchers.begin(), application_launchers.end(),
+        [](const AppLauncher& launcher) { return !launcher.cover.empty(); });
+
+    // applied with the swap interval during setup
+    present_mode = config.present_mode == "limiter" ? Limited : VSync;
+    frame_rate   = config.present_fps;
+    gpu_finish   = config.present_finish;
+
+    // counters for the node exporter's textfile collector
+    if (!config.metrics_path.empty())
+        metrics().start(config.metrics_path, std::chrono::seconds(config.metrics_interval));
+
+    // installed games, merged into the app list as library folders are scanned
+    library.start(config.libraries, config_path / "library.toml");
+
+    // modes and apps picked by each client before
+    {
+        auto scope = timeline().scope("profiles");
+        profiles.load(config_path / "profiles.toml");
+    }
+}
+
+void MyApp::run()
+{
+    if (resident && !ipc.start([this]() { platform->wake(); })) {
+        Logger::error("Another resident launcher is already running!");
+        return;
+    }
+
+    if (resident) {
+        run_resident();
+    } else {
+        Application::run();
+    }
+
+    control.stop();
+    ipc.stop();
+
+    // last export with the final counts, while the logger is still alive
+    metrics().stop();
+}
+
+void MyApp::run_resident()
+{
+    setup();
+
+    // sessions fall back to best-fit modes, have them ready
+    fitter.precompute();
+
+    bool running = true;
+    while (running) {
+        for (const auto& message : ipc.poll()) {
+            if (message.type == IpcType::Quit) {
+                // stream ended, put the host back the way it was
+                if (!dry_run)
+                    restore_display_session();
+                running = false;
+            } else if (message.type == IpcType::Show) {
+                show(message.width, message.height, message.frequency > 0 ? message.frequency : 60);
+            }
+        }
+
+        // nothing to draw, sleep until the next request
+        if (!visible) {
+            if (running)
+                platform->wait(-1.0);
+            continue;
+        }
+
+        frame();
+
+        // exit and launch hide the window instead of closing it
+        if (platform->should_close()) {
+            platform->hide();
+            visible = false;
+            Logger::info("Hidden, waiting for the next session");
+        }
+    }
+
+    cleanup();
+}
+
+void MyApp::show(uint width, uint height, uint frequency)
+{
+    // keep the current extent when the client did not report one
+    if (width > 0 && height > 0) {
+        this->width  = width;
+        this->height = height;
+        fit(width, height, frequency);
+        configure_present(); // limiter follows the refresh rate
+    }
+
+    Logger::info("Showing at {}x{}", this->width, this->height);
+    redraw.invalidate();
+    platform->show(this->width, this->height);
+    visible = true;
+}
+
+static std::string control_status(ControlStatus status)
+{
+    ControlWriter writer{};
+    writer.u8(static_cast<uint8_t>(status));
+    return writer.buffer;
+}
+
+std::string MyApp::handle_control(std::string_view request)
+{
+    ControlReader reader(request);
+    ControlWriter writer{};
+
+    switch (static_cast<ControlCommand>(reader.u8())) {
+        case ControlCommand::ListModes: {
+            writer.u8(static_cast<uint8_t>(ControlStatus::Ok));
+            writer.u32(static_cast<uint32_t>(preset_display_settings.size() + supported_display_settings.size()));
+            for (const auto* display_settings : {&preset_display_settings, &supported_display_settings}) {
+                for (const auto& settings : *display_settings) {
+                    writer.u8(display_settings == &preset_display_settings);
+                    writer.str(settings.name);
+                    writer.i32(settings.width);
+                    writer.i32(settings.height);
+                    writer.i32(settings.frequency);
+                    writer.f32(settings.scale);
+                }
+            }
+            return writer.buffer;
+        }
+
+        case ControlCommand::ApplyMode: {
+            int32_t width  = reader.i32();
+            int32_t height = reader.i32();
+            if (!reader.ok)
+                return control_status(ControlStatus::BadRequest);
+
+            // only modes the launcher offers, on the monitors of the preset
+            const DisplaySettings* settings = find_display_settings(preset_display_settings, width, height);
+            if (!settings)
+                settings = find_display_settings(supported_display_settings, width, height);
+            if (!settings)
+                return control_status(ControlStatus::NotFound);
+
+            return control_status(update_resolution(width, height, settings->frequency, settings->monitors) ? ControlStatus::Ok : ControlStatus::Failed);
+        }
+
+        case ControlCommand::ApplyScale: {
+            float scale = reader.f32();
+            if (!reader.ok || scale < 1.0f)
+                return control_status(ControlStatus::BadRequest);
+
+            return control_status(update_scale(scale) ? ControlStatus::Ok : ControlStatus::Failed);
+        }
+
+        case ControlCommand::Launch: {
+            std::string name = reader.str();
+            if (!reader.ok)
+                return control_status(ControlStatus::BadRequest);
+
+            // launch a copy, the UI thread owns the list
+            AppLauncher launcher{};
+            {
+                std::lock_guard<std::mutex> lock(launchers_mutex);
+                auto it = std::find_if(application_launchers.begin(), application_launchers.end(),
+                    [&](const AppLauncher& launcher) { return launcher.name == name; });
+                if (it == application_launchers.end())
+                    return control_status(ControlStatus::NotFound);
+                launcher = *it;
+            }
+
+            if (dry_run) {
+                Logger::info("[Dry run] launch {}", name);
+                return control_status(ControlStatus::Ok);
+            }
+
+            return control_status(launcher.launch() ? ControlStatus::Ok : ControlStatus::Failed);
+        }
+
+        case ControlCommand::Status: {
+            auto current = get_current_display_settings();
+            writer.u8(static_cast<uint8_t>(ControlStatus::Ok));
+            writer.i32(current.width);
+            writer.i32(current.height);
+            writer.i32(current.frequency);
+            writer.f32(current.scale);
+            writer.u8(resident);
+            writer.u64(control.requests);
+            return writer.buffer;
+        }
+    }
+
+    return control_status(ControlStatus::UnknownCommand);
+}
+
+void MyApp::tick()
+{
+    import_apps();
+
+    // a few covers per frame, scrolling stays smooth while a page of them decodes
+    if (covers.update(std::chrono::milliseconds(2)))
+        redraw.invalidate();
+
+    platform->focus();
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoBringToFrontOnFocus;
+    ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Moonlight Launcher", 0, flags);
+    {
+        render_vtabs();
+    }
+    ImGui::End();
+}
+
+void MyApp::setup()
+{
+    // the UI's shaders load as binaries linked on a previous run
+    auto app_config_path = get_app_config_path(APP_NAME);
+    if (!renderer && app_config_path.has_value())
+        renderer = std::make_unique<OpenGLRenderer>((std::filesystem::path(app_config_path.value()) / "programs.bin").string());
+
+    Application::setup();
+
+    // decoded off the UI thread, each finished cover wakes the frame loop
+    covers.start(renderer.get(), cover_budget, 2, [this]() { platform->wake(); });
+
+    // scripts drive the launcher through the control pipe while the UI runs,
+    // only once the setup tasks are joined: requests read the modes and presets unlocked
+    if (control_pipe)
+        control.start([this](std::string_view request) { return handle_control(request); });
+}
+
+void MyApp::setup_tasks(TaskGraph& graph, SetupTasks& tasks)
+{
+    Application::setup_tasks(graph, tasks);
+    if (!deferred_init)
+        return;
+
+    // neither needs the window, both run while it is created
+    auto modes  = graph.add("modes", [this]() { init_modes(); });
+    auto config = graph.add("config", [this]() { init_config(); });
+    graph.depend(tasks.present, config);
+
+    // the content scale and refresh rate of the window change with the applied mode
+    if (fit_width > 0 && fit_height > 0) {
+        auto fit = graph.add("fit", [this]() { this->fit(fit_width, fit_height, fit_frequency); }, {modes, config});
+        graph.depend(tasks.scale, fit);
+        graph.depend(tasks.present, fit);
+    }
+}
+
+void MyApp::cleanup()
+{
+    // textures go before the renderer
+    covers.stop();
+
+    Application::cleanup();
+}
+
+bool MyApp::is_up_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_UpArrow)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadDpadUp));
+}
+
+bool MyApp::is_down_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_DownArrow)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadDpadDown));
+}
+
+bool MyApp::is_left_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_LeftArrow)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadDpadLeft));
+}
+
+bool MyApp::is_right_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_RightArrow)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadDpadRight));
+}
+
+bool MyApp::is_view_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_G)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadFaceUp));
+}
+
+bool MyApp::is_enter_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Enter)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadFaceDown));
+}
+
+bool MyApp::is_next_tab_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadR1)) ||
+           (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Tab)) && !ImGui::GetIO().KeyShift);
+}
+
+bool MyApp::is_prev_tab_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadL1)) ||
+           (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Tab)) && ImGui::GetIO().KeyShift);
+}
+
+bool MyApp::is_exit_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Escape)) ||
+           (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadStart)) && ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadBack)));
+}
+
+bool MyApp::is_logger_pressed()
+{
+    return ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GraveAccent)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_GamepadBack));
+}
+
+void MyApp::render_vtabs()
+{
+    ImGui::BeginChild("Tab Buttons", ImVec2(150, 0), true);
+    {
+        render_tab_button(ICON_FA_HOME, 0, tab_index);
+        render_tab_button(ICON_FA_LAPTOP, 1, tab_index);
+        render_tab_button(ICON_FA_CUBE, 2, tab_index);
+        render_tab_button(ICON_FA_INFO_CIRCLE, 3, tab_index);
+        render_tab_button(ICON_FA_BUG, 4, tab_index);
+        render_exit_button(ICON_FA_POWER_OFF);
+    }
+    ImGui::EndChild();
+
+    ImGui::SameLine();
+
+    ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.6f, 0.6f, 0.6f, 0.6f));
+    ImGui::BeginChild("Tab Content", ImVec2(0, 0), true);
+    {
+        // clang-format off
+        switch (tab_index)
+        {
+            case 0: render_displays("##Presets", preset_display_settings);      break;
+            case 1: render_displays("##Supported", supported_display_settings); break;
+            case 2: render_launcher();                                          break;
+            case 3: render_helpmenu();                                          break;
+            case 4: render_logs();                                              break;
+        }
+        // clang-format on
+    }
+    ImGui::EndChild();
+    ImGui::PopStyleColor();
+
+    // next tab
+    if (is_next_tab_pressed()) {
+        tab_index = (tab_index + 1) % tab_count;
+    }
+
+    // prev tab
+    if (is_prev_tab_pressed()) {
+        tab_index = (tab_index - 1) % tab_count;
+    }
+
+    if (is_exit_pressed()) {
+        platform->close();
+    }
+}
+
+void MyApp::render_tab_button(const char* label, int tab_index, int& selected_tab)
+{
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
+
+    // adjust selectable padding
+    ImVec2 txt_size = ImGui::CalcTextSize(label);
+    ImVec2 row_size = ImGui::GetContentRegionAvail();
+    ImVec2 sel_size = ImVec2(0, row_size.x);
+    float  offset_x = std::max(0.0f, (row_size.x - txt_size.x) / 2.0f);
+    float  offset_y = std::max(0.0f, (row_size.x - txt_size.y) / 2.0f);
+
+    // render selectable placeholder
+    const char* id = arena.format("##%s-%d", label, tab_index);
+    if (ImGui::Selectable(id, selected_tab == tab_index, 0, sel_size))
+        selected_tab = tab_index;
+
+    // fill selectable content
+    ImGui::SameLine();
+    ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offset_x);
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + offset_y);
+    ImGui::TextUnformatted(label);
+
+    ImGui::PopStyleVar();
+    ImGui::PopStyleVar();
+}
+
+void MyApp::render_exit_button(const char* label)
+{
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
+
+    // adjust selectable padding
+    ImVec2 txt_size = ImGui::CalcTextSize(label);
+    ImVec2 row_size = ImGui::GetContentRegionAvail();
+    ImVec2 sel_size = ImVec2(0, row_size.x);
+    float  offset_x = std::max(0.0f, (row_size.x - txt_size.x) / 2.0f);
+    float  offset_y = std::max(0.0f, (row_size.x - txt_size.y) / 2.0f);
+
+    // render selectable placeholder
+    if (ImGui::Selectable("##exit", false, 0, sel_size))
+        platform->close();
+
+    // fill selectable content
+    ImGui::SameLine();
+    ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offset_x);
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + offset_y);
+    ImGui::TextUnformatted(label);
+
+    ImGui::PopStyleVar();
+    ImGui::PopStyleVar();
+}
+
+void MyApp::render_displays(const char* name, const std::vector<DisplaySettings>& display_settings)
+{
+    static int sel_index = 0;
+
+    bool  execute = false;
+    bool  is_key  = is_up_pressed() || is_down_pressed();
+    float height  = ImGui::GetContentRegionAvail().y;
+
+    ImGui::PushItemWidth(-1);
+    if (ImGui::ListBoxHeader(name, ImVec2(-1, height))) {
+        for (size_t i = 0; i < display_settings.size(); i++) {
+            const auto& settings = display_settings.at(i);
+            const bool  selected = sel_index == i;
+
+            ImGui::Selectable(display_label(arena, settings), selected);
+
+            if (ImGui::IsItemHovered()) {
+                sel_index = i;
+                execute   = false;
+            }
+
+            if (ImGui::IsItemClicked()) {
+                sel_index = i;
+                execute   = true;
+            }
+
+            if (is_key && sel_index == i) {
+                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + ImGui::GetCursorPosY(), 0.5f);
+            }
+        }
+        ImGui::ListBoxFooter();
+    }
+    ImGui::PopItemWidth();
+
+    if (is_up_pressed()) {
+        sel_index = (sel_index - 1 + display_settings.size()) % display_settings.size();
+        platform->show_cursor(false);
+    }
+
+    if (is_down_pressed()) {
+        sel_index = (sel_index + 1) % display_settings.size();
+        platform->show_cursor(false);
+    }
+
+    if (is_enter_pressed()) {
+        execute = true;
+    }
+
+    if (execute && dry_run) {
+        auto& settings = display_settings.at(sel_index);
+        Logger::info("[Dry run] switch to {}x{}", settings.width, settings.height);
+    } else if (execute) {
+        auto& settings = display_settings.at(sel_index);
+        apply_display_settings(settings);
+        applied = settings;
+    }
+}
+
+void MyApp::render_launcher()
+{
+    static int sel_index = 0;
+
+    bool execute = false;
+    bool is_key  = is_up_pressed() || is_down_pressed() || (grid && (is_left_pressed() || is_right_pressed()));
+
+    if (is_view_pressed()) {
+        grid         = !grid;
+        grid_toggled = true;
+        is_key       = true;
+    }
+
+    if (grid) {
+        render_app_grid(sel_index, execute, is_key);
+    } else {
+        render_app_list(sel_index, execute, is_key);
+    }
+
+    // a row up or down in the grid, the next app in the list
+    int count = static_cast<int>(application_launchers.size());
+    int step  = grid ? grid_columns : 1;
+    if (count == 0) {
+        sel_index = 0;
+        return;
+    }
+    sel_index = std::min(sel_index, count - 1);
+
+    if (is_up_pressed()) {
+        sel_index = grid ? (sel_index >= step ? sel_index - step : sel_index) : (sel_index - 1 + count) % count;
+        platform->show_cursor(false);
+    }
+
+    if (is_down_pressed()) {
+        sel_index = grid ? (sel_index + step < count ? sel_index + step : sel_index) : (sel_index + 1) % count;
+        platform->show_cursor(false);
+    }
+
+    if (grid && is_left_pressed()) {
+        sel_index = (sel_index - 1 + count) % count;
+        platform->show_cursor(false);
+    }
+
+    if (grid && is_right_pressed()) {
+        sel_index = (sel_index + 1) % count;
+        platform->show_cursor(false);
+    }
+
+    if (is_enter_pressed()) {
+        execute = true;
+    }
+
+    // scrolling past an app does not read its files
+    if (sel_index != prefetch_index) {
+        prefetcher.cancel();
+        prefetch_index   = sel_index;
+        prefetch_since   = ImGui::GetTime();
+        prefetch_started = false;
+    } else if (!prefetch_started && !dry_run && ImGui::GetTime() - prefetch_since > 0.15) {
+        prefetcher.start(application_launchers.at(sel_index).prefetch);
+        prefetch_started = true;
+    }
+
+    if (execute) {
+        auto& launcher = application_launchers.at(sel_index);
+        if (dry_run) {
+            Logger::info("[Dry run] launch {}", launcher.name);
+        } else {
+            // the app reads the rest itself, without competing with the prefetch
+            prefetcher.report(launcher.name);
+            prefetcher.cancel();
+            remember(launcher.name);
+            if (!launcher.launch())
+                exit(1);
+        }
+        platform->close();
+    }
+}
+
+void MyApp::render_app_list(int& selected, bool& execute, bool scroll)
+{
+    float height = ImGui::GetContentRegionAvail().y;
+
+    ImGui::PushItemWidth(-1);
+    if (ImGui::ListBoxHeader("#app-launcher", ImVec2(-1, height))) {
+        for (int i = 0; i < static_cast<int>(application_launchers.size()); i++) {
+            const auto& settings = application_launchers.at(i);
+
+            ImGui::Selectable(launcher_label(arena, settings), selected == i);
+
+            if (ImGui::IsItemHovered()) {
+                selected = i;
+                execute  = false;
+            }
+
+            if (ImGui::IsItemClicked()) {
+                selected = i;
+                execute  = true;
+            }
+
+            if (scroll && selected == i) {
+                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + ImGui::GetCursorPosY(), 0.5f);
+            }
+        }
+        ImGui::ListBoxFooter();
+    }
+    ImGui::PopItemWidth();
+}
+
+void MyApp::render_app_grid(int& selected, bool& execute, bool scroll)
+{
+    const ImGuiStyle& style = ImGui::GetStyle();
+
+    // portrait tiles sized with the font, covers are decoded at this size
+    float tile_width  = ImGui::GetFontSize() * 7.0f;
+    float tile_height = tile_width * 1.5f;
+    float caption     = ImGui::GetTextLineHeight();
+    float row_height  = tile_height + caption + style.ItemSpacing.y * 2.0f;
+
+    ImGui::BeginChild("#app-grid", ImVec2(0, 0), false);
+    {
+        int count    = static_cast<int>(application_launchers.size());
+        grid_columns = std::max(1, static_cast<int>((ImGui::GetContentRegionAvail().x + style.ItemSpacing.x) / (tile_width + style.ItemSpacing.x)));
+        int rows     = (count + grid_columns - 1) / grid_columns;
+
+        if (scroll) {
+            float center = (selected / grid_columns) * row_height + row_height * 0.5f;
+            ImGui::SetScrollY(std::max(0.0f, center - ImGui::GetWindowHeight() * 0.5f));
+        }
+
+        // only rows in view are laid out, so only their covers are requested
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, row_height);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                for (int column = 0; column < grid_columns; column++) {
+                    int i = row * grid_columns + column;
+                    if (i >= count)
+                        break;
+
+                    const auto& launcher = application_launchers.at(i);
+                    if (column > 0)
+                        ImGui::SameLine();
+
+                    ImGui::PushID(i);
+                    ImVec2 min = ImGui::GetCursorScreenPos();
+                    ImVec2 max = ImVec2(min.x + tile_width, min.y + tile_height);
+                    ImGui::Selectable("##tile", selected == i, 0, ImVec2(tile_width, row_height - style.ItemSpacing.y));
+
+                    if (ImGui::IsItemHovered()) {
+                        selected = i;
+                        execute  = false;
+                    }
+
+                    if (ImGui::IsItemClicked()) {
+                        selected = i;
+                        execute  = true;
+                    }
+
+                    ImDrawList* draw  = ImGui::GetWindowDrawList();
+                    Cover       cover = launcher.cover.empty() ? Cover{} : covers.request(launcher.cover, static_cast<int>(tile_width), static_cast<int>(tile_height));
+                    if (cover.texture) {
+                        // letterboxed, covers are decoded with their aspect
+                        float  scale  = std::min(tile_width / cover.width, tile_height / cover.height);
+                        ImVec2 size   = ImVec2(cover.width * scale, cover.height * scale);
+                        ImVec2 offset = ImVec2((tile_width - size.x) * 0.5f, (tile_height - size.y) * 0.5f);
+                        draw->AddImage(cover.texture, ImVec2(min.x + offset.x, min.y + offset.y), ImVec2(min.x + offset.x + size.x, min.y + offset.y + size.y));
+                    } else {
+                        // placeholder until the cover is uploaded, or for apps without one
+                        draw->AddRectFilled(min, max, IM_COL32(40, 40, 40, 200));
+                        draw->AddText(ImGui::GetFont(), ImGui::GetFontSize(), ImVec2(min.x + style.FramePadding.x, min.y + style.FramePadding.y),
+                            ImGui::GetColorU32(ImGuiCol_Text), launcher.name.c_str(), nullptr, tile_width - style.FramePadding.x * 2.0f);
+                    }
+
+                    if (selected == i)
+                        draw->AddRect(min, max, ImGui::GetColorU32(ImGuiCol_HeaderActive), 0.0f, 0, 3.0f);
+
+                    // name below the tile, clipped to its width
+                    draw->PushClipRect(ImVec2(min.x, max.y), ImVec2(max.x, max.y + caption + style.ItemSpacing.y), true);
+                    draw->AddText(ImVec2(min.x, max.y + style.ItemSpacing.y * 0.5f), ImGui::GetColorU32(ImGuiCol_Text), launcher.name.c_str());
+                    draw->PopClipRect();
+                    ImGui::PopID();
+                }
+            }
+        }
+        clipper.End();
+    }
+    ImGui::EndChild();
+}
+
+void MyApp::render_helpmenu()
+{
+    // clang-format off
+    static const char* const shortcuts[][3] = {
+        {"Next Tab",   PF_KEYBOARD_TAB,                   PF_SONY_RIGHT_SHOULDER,        },
+        {"Prev Tab",   PF_KEYBOARD_SHIFT PF_KEYBOARD_TAB, PF_SONY_LEFT_SHOULDER,         },
+        {"Next Item",  PF_KEYBOARD_DOWN,                  PF_DPAD_DOWN,                  },
+        {"Prev Item",  PF_KEYBOARD_UP,                    PF_DPAD_UP,                    },
+        {"Grid Left",  PF_KEYBOARD_LEFT,                  PF_DPAD_LEFT,                  },
+        {"Grid Right", PF_KEYBOARD_RIGHT,                 PF_DPAD_RIGHT,                 },
+        {"Grid/List",  PF_KEYBOARD_G,                     PF_SONY_Y,                     },
+        {"Select",     PF_KEYBOARD_ENTER,                 PF_SONY_A,                     },
+        {"Exit",       PF_KEYBOARD_ESCAPE,                PF_SONY_OPTIONS PF_SONY_SHARE, },
+    };
+    // clang-format on
+
+    float width  = ImGui::GetContentRegionAvail().x - 16.0f;
+    float height = ImGui::GetContentRegionAvail().y;
+    ImGui::SetCursorPosX(ImGui::GetCursorPosX() + 8.0f);
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 8.0f);
+    if (ImGui::ListBoxHeader("#shortcuts", ImVec2(width, height - 8.0f))) {
+        if (ImGui::BeginTable("Shortcuts##table", 3)) {
+            ImGui::TableHeadersRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("Action");
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("Keyboard");
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("Gamepad");
+            ImGui::TableNextRow();
+            ImGui::Separator();
+
+            for (auto& row : shortcuts) {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(row[0]);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextUnformatted(row[1]);
+                ImGui::TableSetColumnIndex(2);
+                ImGui::TextUnformatted(row[2]);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::ListBoxFooter();
+    }
+}
+
+void MyApp::render_logs()
+{
+    if (FrameProfiler::enabled)
+        ImGui::Checkbox("Frame profiler overlay", &profiler.visible);
+
+    uint64_t frames = redraw.submitted + redraw.skipped;
+    ImGui::Checkbox("Skip unchanged frames", &redraw.enabled);
+    ImGui::Text(" Frames submitted: %llu, skipped: %llu (%.1f%%)",
+        static_cast<unsigned long long>(redraw.submitted),
+        static_cast<unsigned long long>(redraw.skipped),
+        frames > 0 ? 100.0 * redraw.skipped / frames : 0.0);
+    ImGui::Text(" Prefetched: %.1f of %.1f MiB%s, %.1f MiB since start",
+        prefetcher.bytes / (1024.0 * 1024.0), prefetcher.total / (1024.0 * 1024.0),
+        prefetcher.running() ? " (reading)" : "", prefetcher.bytes_all / (1024.0 * 1024.0));
+    ImGui::Text(" UI allocations: %llu per frame (%llu bytes), arena %zu of %zu bytes",
+        static_cast<unsigned long long>(frame_allocations.count),
+        static_cast<unsigned long long>(frame_allocations.bytes),
+        arena.used(), arena.capacity());
+    ImGui::Text(" Covers: %zu textures, %.1f of %.1f MiB, %llu hits, %llu misses, %llu evicted",
+        covers.textures(), covers.resident() / (1024.0 * 1024.0), cover_budget / (1024.0 * 1024.0),
+        static_cast<unsigned long long>(covers.hits), static_cast<unsigned long long>(covers.misses),
+        static_cast<unsigned long long>(covers.evictions));
+    ImGui::Separator();
+
+    if (latency.enabled)
+        render_latency();
+
+    if (ImGui::CollapsingHeader("Metrics"))
+        render_metrics();
+
+    if (!logs)
+        return;
+
+    // under the sink's lock, other threads keep logging while the tab is open
+    logs->visit([](const std::string& log) { ImGui::Text(" %s", log.c_str()); });
+}
+
+void MyApp::render_metrics()
+{
+    // the values exported to the metrics file
+    metrics().visit([](const Metrics::Entry& entry) {
+        switch (entry.type) {
+        case Metrics::CounterType:
+            ImGui::Text(" %s_total: %llu", entry.name, static_cast<unsigned long long>(static_cast<const Counter*>(entry.metric)->get()));
+            break;
+        case Metrics::GaugeType:
+            ImGui::Text(" %s: %lld", entry.name, static_cast<long long>(static_cast<const Gauge*>(entry.metric)->get()));
+            break;
+        case Metrics::HistogramType: {
+            const auto& histogram = *static_cast<const Histogram*>(entry.metric);
+            ImGui::Text(" %s: %llu, mean %.4g, p50 <= %g, p99 <= %g", entry.name,
+                static_cast<unsigned long long>(histogram.count()),
+                histogram.count() > 0 ? histogram.sum() / histogram.count() : 0.0,
+                histogram.estimate(0.50), histogram.estimate(0.99));
+            break;
+        }
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("%s", entry.help);
+    });
+}
+
+void MyApp::render_latency()
+{
+    if (!ImGui::CollapsingHeader("Input Latency", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    ImGui::Text(" Present mode: %s", latency.mode.c_str());
+    if (limiter.active())
+        ImGui::Text(" Limiter: %.2f ms period, %llu missed deadlines",
+            std::chrono::duration<double, std::milli>(limiter.period).count(), static_cast<unsigned long long>(limiter.missed));
+    if (ImGui::BeginTable("Latency##table", 6)) {
+        ImGui::TableSetupColumn("Source");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("p50 (ms)");
+        ImGui::TableSetupColumn("p90 (ms)");
+        ImGui::TableSetupColumn("p99 (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableHeadersRow();
+
+        for (int i = 0; i < LatencyTracker::SourceCount; i++) {
+            auto source = static_cast<LatencyTracker::Source>(i);
+            auto stats  = latency.stats(source);
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("%s", LatencyTracker::source_name(source));
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%zu", stats.count);
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.1f", stats.p50);
+            ImGui::TableSetColumnIndex(3);
+            ImGui::Text("%.1f", stats.p90);
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%.1f", stats.p99);
+            ImGui::TableSetColumnIndex(5);
+            ImGui::Text("%.1f", stats.max);
+        }
+        ImGui::EndTable();
+    }
+
+    // distribution over 0-100 ms in 2 ms bins
+    for (int i = 0; i < LatencyTracker::SourceCount; i++) {
+        auto source = static_cast<LatencyTracker::Source>(i);
+        auto counts = latency.histogram(source, 50, 100.0f);
+        ImGui::PlotHistogram(LatencyTracker::source_name(source), counts.data(), static_cast<int>(counts.size()),
+            0, "0 - 100 ms", 0.0f, FLT_MAX, ImVec2(-200, 80));
+    }
+    ImGui::Separator();
+}
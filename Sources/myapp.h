@@ -0,0 +1,135 @@
+#ifndef MYAPP_H
+#define MYAPP_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logger.h"
+#include "ipc.h"
+#include "control.h"
+#include "fit.h"
+#include "profile.h"
+#include "prefetch.h"
+#include "covers.h"
+#include "library.h"
+#include "display.h"
+#include "launcher.h"
+#include "application.h"
+
+struct MyApp : public Application
+{
+    // exact preset or supported mode, otherwise the closest supported one
+    void fit(uint width, uint height, uint frequency = 60);
+
+    // enumerate display modes and load the config file
+    void init();
+
+    // the two halves of init(), independent of each other
+    void init_modes();
+    void init_config();
+
+    // apply the mode and launch the app of the client's profile when it was picked
+    // at least `confidence` sessions in a row, false to fall back to the UI;
+    // loads the profiles and config itself, call it instead of init()
+    bool auto_launch(int confidence);
+
+    // record the applied mode and `app` in the client's profile
+    void remember(const std::string& app);
+
+    // append apps found by the library scan so far, config apps keep their names
+    void import_apps();
+
+    void run() override;
+
+    // resident mode stays alive hidden and shows on IPC requests
+    void run_resident();
+
+    void show(uint width, uint height, uint frequency);
+
+    // control pipe request, called on the control server thread
+    std::string handle_control(std::string_view request);
+
+    void tick() override;
+
+    // start and stop the cover decoders with the renderer
+    void setup() override;
+    void cleanup() override;
+
+    // init() and fit() as setup tasks when deferred
+    void setup_tasks(TaskGraph& graph, SetupTasks& tasks) override;
+
+    bool is_up_pressed();
+    bool is_down_pressed();
+    bool is_left_pressed();
+    bool is_right_pressed();
+    bool is_view_pressed();
+    bool is_enter_pressed();
+    bool is_next_tab_pressed();
+    bool is_prev_tab_pressed();
+    bool is_exit_pressed();
+    bool is_logger_pressed();
+
+    void render_vtabs();
+    void render_tab_button(const char* label, int tab_index, int& selected_tab);
+    void render_exit_button(const char* label);
+    void render_displays(const char* name, const std::vector<DisplaySettings>& display_settings);
+    void render_launcher();
+    void render_app_list(int& selected, bool& execute, bool scroll);
+    void render_app_grid(int& selected, bool& execute, bool scroll);
+    void render_helpmenu();
+    void render_logs();
+    void render_latency();
+    void render_metrics();
+
+    std::vector<DisplaySettings> preset_display_settings{};
+    std::vector<DisplaySettings> supported_display_settings{};
+    std::vector<AppLauncher>     application_launchers{};
+    std::mutex                   launchers_mutex{}; // imports append while the control thread reads
+    LibraryImporter              library{};
+    ModeFitter                   fitter{};
+    ProfileCache                 profiles{};
+    DisplaySettings              applied{"", 0, 0, 0, 1.0f}; // mode applied this session
+
+    // profile key, empty when not started by Sunshine
+    std::string client = "";
+
+    // shown on the logs tab
+    std::shared_ptr<RingBufferSink> logs{};
+
+    IpcServer     ipc{};
+    ControlServer control{};
+
+    // files of the highlighted app, started once the selection rests
+    Prefetcher prefetcher{};
+    int        prefetch_index   = -1;
+    double     prefetch_since   = 0.0;
+    bool       prefetch_started = false;
+
+    // cover art of the grid view, shown once any app has a cover unless toggled
+    CoverCache covers{};
+    size_t     cover_budget = 128ull << 20;
+    bool       grid         = false;
+    bool       grid_toggled = false;
+    int        grid_columns = 1;
+
+    // init() and fit() overlap with window creation instead of running before setup()
+    bool deferred_init = false;
+    uint fit_width     = 0; // mode fitted during setup, none when 0
+    uint fit_height    = 0;
+    uint fit_frequency = 60;
+
+    int  tab_index    = 0;
+    int  tab_count    = 5;
+    bool dry_run      = false; // log display changes and launches instead of doing them
+    bool resident     = false;
+    bool control_pipe = false; // serve the control pipe
+};
+
+// list labels, valid until the arena is reset
+const char* display_label(FrameArena& arena, const DisplaySettings& settings);
+
+const char* launcher_label(FrameArena& arena, const AppLauncher& launcher);
+
+#endif // MYAPP_H
@@ -0,0 +1,50 @@
+#include "opengl.h"
+
+template <typename T>
+static void load_proc(T& proc, const char* name)
+{
+    proc = reinterpret_cast<T>(glfwGetProcAddress(name));
+}
+
+void OpenGLExtensions::load()
+{
+    // no context, e.g. with the software renderer
+    GLFWwindow* context = glfwGetCurrentContext();
+    if (!context)
+        return;
+
+    // timer queries are core since 3.3, otherwise require the ARB extension
+    int major = glfwGetWindowAttrib(context, GLFW_CONTEXT_VERSION_MAJOR);
+    int minor = glfwGetWindowAttrib(context, GLFW_CONTEXT_VERSION_MINOR);
+    if (major * 10 + minor >= 33 || glfwExtensionSupported("GL_ARB_timer_query")) {
+        load_proc(GenQueries, "glGenQueries");
+        load_proc(DeleteQueries, "glDeleteQueries");
+        load_proc(BeginQuery, "glBeginQuery");
+        load_proc(EndQuery, "glEndQuery");
+        load_proc(GetQueryObjectiv, "glGetQueryObjectiv");
+        load_proc(GetQueryObjectui64v, "glGetQueryObjectui64v");
+    }
+
+    // program binaries are core since 4.1
+    if (major * 10 + minor >= 41 || glfwExtensionSupported("GL_ARB_get_program_binary")) {
+        load_proc(GetProgramBinary, "glGetProgramBinary");
+        load_proc(ProgramBinary, "glProgramBinary");
+        load_proc(ProgramParameteri, "glProgramParameteri");
+    }
+}
+
+bool OpenGLExtensions::has_timer_queries() const
+{
+    return GenQueries && DeleteQueries && BeginQuery && EndQuery && GetQueryObjectiv && GetQueryObjectui64v;
+}
+
+bool OpenGLExtensions::has_program_binaries() const
+{
+    return GetProgramBinary && ProgramBinary && ProgramParameteri;
+}
+
+OpenGLExtensions& gl_extensions()
+{
+    static OpenGLExtensions extensions;
+    return extensions;
+}
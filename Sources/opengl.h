@@ -0,0 +1,65 @@
+#ifndef OPENGL_H
+#define OPENGL_H
+
+#include <GLFW/glfw3.h>
+
+#ifdef _WIN32
+#define OPENGL_API __stdcall
+#else
+#define OPENGL_API
+#endif
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+using GLuint64_t = unsigned long long;
+
+// OpenGL entry points beyond 1.1 used outside of the ImGui backend,
+// loaded at runtime from the current context.
+struct OpenGLExtensions
+{
+    // timer queries (OpenGL 3.3 / ARB_timer_query)
+    void(OPENGL_API* GenQueries)(GLsizei n, GLuint* ids)                               = nullptr;
+    void(OPENGL_API* DeleteQueries)(GLsizei n, const GLuint* ids)                      = nullptr;
+    void(OPENGL_API* BeginQuery)(GLenum target, GLuint id)                             = nullptr;
+    void(OPENGL_API* EndQuery)(GLenum target)                                          = nullptr;
+    void(OPENGL_API* GetQueryObjectiv)(GLuint id, GLenum pname, GLint* params)         = nullptr;
+    void(OPENGL_API* GetQueryObjectui64v)(GLuint id, GLenum pname, GLuint64_t* params) = nullptr;
+
+    // program binaries (OpenGL 4.1 / ARB_get_program_binary)
+    void(OPENGL_API* GetProgramBinary)(GLuint program, GLsizei size, GLsizei* length, GLenum* format, void* binary) = nullptr;
+    void(OPENGL_API* ProgramBinary)(GLuint program, GLenum format, const void* binary, GLsizei length)           = nullptr;
+    void(OPENGL_API* ProgramParameteri)(GLuint program, GLenum pname, GLint value)                               = nullptr;
+
+    // requires a current GL context
+    void load();
+
+    bool has_timer_queries() const;
+
+    bool has_program_binaries() const;
+};
+
+OpenGLExtensions& gl_extensions();
+
+#endif // OPENGL_H
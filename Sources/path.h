@@ -5,8 +5,11 @@
 #include <shlobj.h>
 #include <optional>
 #include <string>
+#include <filesystem>
 
-inline std::optional<std::string> get_app_config_path(const std::string& app = "Moonlight-Launcher")
+#define APP_NAME "Moonlight-Launcher"
+
+inline std::optional<std::string> get_app_config_path(const std::string& app = APP_NAME)
 {
     char path[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPath(NULL, CSIDL_APPDATA, NULL, 0, path))) {
@@ -15,4 +18,24 @@ inline std::optional<std::string> get_app_config_path(const std::string& app = "
     return std::nullopt;
 }
 
+// write to a temporary file, flush and move it over `path`, a crash leaves either the old or the new file
+inline bool write_file_atomic(const std::filesystem::path& path, const std::string& content)
+{
+    std::string temporary = path.string() + ".tmp";
+    HANDLE      file      = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    DWORD written = 0;
+    bool  success = WriteFile(file, content.data(), static_cast<DWORD>(content.size()), &written, NULL) &&
+                   written == content.size() && FlushFileBuffers(file);
+    CloseHandle(file);
+
+    if (!success || !MoveFileExA(temporary.c_str(), path.string().c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        DeleteFileA(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
 #endif // PATH_H
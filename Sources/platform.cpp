@@ -0,0 +1,328 @@
+#include <fstream>
+#include <algorithm>
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+
+#include "logger.h"
+#include "platform.h"
+#include "application.h"
+
+// ---------------------------------------------------------------------------
+
+static void on_move(GLFWwindow* window, double xpos, double ypos)
+{
+    // restore access to cursor on mouse move
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+
+    auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    app->latency.input(LatencyTracker::Mouse);
+}
+
+static void on_button(GLFWwindow* window, int button, int action, int mods)
+{
+    auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    app->latency.input(LatencyTracker::Mouse);
+}
+
+static void on_scroll(GLFWwindow* window, double xoffset, double yoffset)
+{
+    auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    app->latency.input(LatencyTracker::Mouse);
+}
+
+static void on_key(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+    auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    app->latency.input(LatencyTracker::Keyboard);
+}
+
+static void on_scale(GLFWwindow* window, float xscale, float yscale)
+{
+    ImGuiIO& io = ImGui::GetIO();
+
+    io.DisplayFramebufferScale = ImVec2(xscale, yscale);
+}
+
+static void on_error(int error, const char* description)
+{
+    Logger::error("[GLFW] Error: {}\n", description);
+}
+
+// ---------------------------------------------------------------------------
+
+bool GlfwPlatform::init(Application& app)
+{
+    if (!glfwInit()) {
+        Logger::error("[GLFW] failed to initialize GLFW!");
+        return false;
+    }
+
+    // create window
+    glfwWindowHint(GLFW_DECORATED, app.decorated ? GLFW_TRUE : GLFW_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, app.visible ? GLFW_TRUE : GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    window = glfwCreateWindow(app.width, app.height, app.title.c_str(), nullptr, nullptr);
+    if (!window) {
+        Logger::error("[GLFW] failed to create window!");
+        glfwTerminate();
+        return false;
+    }
+
+    // callbacks
+    glfwSetWindowUserPointer(window, &app);
+    glfwSetErrorCallback(on_error);
+    glfwSetKeyCallback(window, on_key);
+    glfwSetCursorPosCallback(window, on_move);
+    glfwSetMouseButtonCallback(window, on_button);
+    glfwSetScrollCallback(window, on_scroll);
+    glfwSetWindowContentScaleCallback(window, on_scale);
+
+    // OpenGL context, the swap interval is set with the present mode
+    glfwMakeContextCurrent(window);
+
+    // ImGui platform backend
+    ImGui_ImplGlfw_InitForOpenGL(window, true);
+
+    // scale
+    glfwGetWindowContentScale(window, &app.xscale, &app.yscale);
+    return true;
+}
+
+void GlfwPlatform::shutdown()
+{
+    ImGui_ImplGlfw_Shutdown();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    window = nullptr;
+}
+
+void GlfwPlatform::new_frame()
+{
+    ImGui_ImplGlfw_NewFrame();
+}
+
+void GlfwPlatform::present()
+{
+    glfwSwapBuffers(window);
+}
+
+bool GlfwPlatform::swap_interval(int interval)
+{
+    glfwSwapInterval(interval);
+    return true;
+}
+
+int GlfwPlatform::refresh_rate()
+{
+    if (GLFWmonitor* monitor = glfwGetPrimaryMonitor())
+        if (const GLFWvidmode* mode = glfwGetVideoMode(monitor))
+            return std::max(mode->refreshRate, 1);
+    return 60;
+}
+
+void GlfwPlatform::wait(double timeout)
+{
+    if (timeout > 0.0) {
+        glfwWaitEventsTimeout(timeout);
+    } else if (timeout < 0.0) {
+        glfwWaitEvents();
+    } else {
+        glfwPollEvents();
+    }
+}
+
+void GlfwPlatform::wake()
+{
+    glfwPostEmptyEvent();
+}
+
+void GlfwPlatform::framebuffer_size(int& width, int& height)
+{
+    glfwGetFramebufferSize(window, &width, &height);
+}
+
+void GlfwPlatform::content_scale(float& xscale, float& yscale)
+{
+    glfwGetWindowContentScale(window, &xscale, &yscale);
+}
+
+bool GlfwPlatform::should_close()
+{
+    return glfwWindowShouldClose(window);
+}
+
+void GlfwPlatform::close()
+{
+    glfwSetWindowShouldClose(window, GLFW_TRUE);
+}
+
+void GlfwPlatform::focus()
+{
+    glfwFocusWindow(window);
+}
+
+void GlfwPlatform::show(int width, int height)
+{
+    glfwSetWindowShouldClose(window, GLFW_FALSE);
+    glfwSetWindowSize(window, width, height);
+    glfwShowWindow(window);
+    glfwFocusWindow(window);
+}
+
+void GlfwPlatform::hide()
+{
+    glfwHideWindow(window);
+}
+
+void GlfwPlatform::show_cursor(bool visible)
+{
+    glfwSetInputMode(window, GLFW_CURSOR, visible ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
+}
+
+bool GlfwPlatform::gamepad_state(int joystick, GLFWgamepadstate& state)
+{
+    return glfwJoystickIsGamepad(joystick) && glfwGetGamepadState(joystick, &state);
+}
+
+const char* GlfwPlatform::gamepad_guid(int joystick)
+{
+    return glfwGetJoystickGUID(joystick);
+}
+
+// ---------------------------------------------------------------------------
+
+NullPlatform::NullPlatform(uint64_t frames, float timestep) : frame_limit(frames), timestep(timestep)
+{
+    frame_times.reserve(frames);
+}
+
+bool NullPlatform::init(Application& app)
+{
+    width  = static_cast<int>(app.width);
+    height = static_cast<int>(app.height);
+
+    app.xscale       = 1.0f;
+    app.yscale       = 1.0f;
+    app.refresh_rate = static_cast<int>(1.0f / timestep);
+    app.latency.mode = "headless";
+
+    ImGuiIO& io                = ImGui::GetIO();
+    io.BackendPlatformName     = "null";
+    io.DisplaySize             = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+    return true;
+}
+
+void NullPlatform::shutdown()
+{
+    if (frame_times.empty())
+        return;
+
+    std::vector<float> sorted = frame_times;
+    std::sort(sorted.begin(), sorted.end());
+
+    float total = 0.0f;
+    for (float ms : sorted)
+        total += ms;
+
+    auto percentile = [&](float p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1))]; };
+    Logger::info("[Headless] {} frames at {}x{}", sorted.size(), width, height);
+    Logger::info("[Headless] frame time avg {:.3f} ms, p50 {:.3f} ms, p90 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+        total / sorted.size(), percentile(0.50f), percentile(0.90f), percentile(0.99f), sorted.back());
+}
+
+bool NullPlatform::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out);
+    if (!file) {
+        Logger::error("Failed to write frame times to {}!", path);
+        return false;
+    }
+
+    file << "frame,ms\n";
+    for (size_t i = 0; i < frame_times.size(); i++)
+        file << i << "," << frame_times[i] << "\n";
+
+    Logger::info("Frame times saved to {}", path);
+    return true;
+}
+
+void NullPlatform::new_frame()
+{
+    auto now = Clock::now();
+    if (frame > 0)
+        frame_times.push_back(std::chrono::duration<float, std::milli>(now - last).count());
+    last = now;
+    frame++;
+
+    ImGuiIO& io    = ImGui::GetIO();
+    io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    io.DeltaTime   = timestep;
+}
+
+void NullPlatform::present() {}
+
+bool NullPlatform::swap_interval(int interval)
+{
+    return false;
+}
+
+int NullPlatform::refresh_rate()
+{
+    return static_cast<int>(1.0f / timestep);
+}
+
+void NullPlatform::wait(double timeout) {}
+
+void NullPlatform::wake() {}
+
+void NullPlatform::framebuffer_size(int& width, int& height)
+{
+    width  = this->width;
+    height = this->height;
+}
+
+void NullPlatform::content_scale(float& xscale, float& yscale)
+{
+    xscale = 1.0f;
+    yscale = 1.0f;
+}
+
+bool NullPlatform::should_close()
+{
+    return closed || frame >= frame_limit;
+}
+
+void NullPlatform::close()
+{
+    closed = true;
+}
+
+void NullPlatform::focus() {}
+
+void NullPlatform::show(int width, int height)
+{
+    this->width  = width;
+    this->height = height;
+    closed       = false;
+}
+
+void NullPlatform::hide() {}
+
+void NullPlatform::show_cursor(bool visible) {}
+
+bool NullPlatform::gamepad_state(int joystick, GLFWgamepadstate& state)
+{
+    return false;
+}
+
+const char* NullPlatform::gamepad_guid(int joystick)
+{
+    return nullptr;
+}
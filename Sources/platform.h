@@ -0,0 +1,127 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+struct Application;
+
+// Windowing, input and presentation layer below Application.
+struct Platform
+{
+    virtual ~Platform() = default;
+
+    // create the window (and graphics context) for the application
+    virtual bool init(Application& app) = 0;
+
+    virtual void shutdown() = 0;
+
+    virtual void new_frame() = 0;
+
+    virtual void present() = 0;
+
+    // 1 for vsync, 0 to present immediately, false when presentation is not paced by the platform
+    virtual bool swap_interval(int interval) = 0;
+
+    // refresh rate of the primary monitor in Hz
+    virtual int refresh_rate() = 0;
+
+    // process pending events, block up to timeout seconds when timeout > 0,
+    // until the next event or wake() when timeout < 0
+    virtual void wait(double timeout) = 0;
+
+    // interrupt wait(), callable from any thread
+    virtual void wake() = 0;
+
+    virtual void framebuffer_size(int& width, int& height) = 0;
+
+    // DPI scale of the window's monitor
+    virtual void content_scale(float& xscale, float& yscale) = 0;
+
+    virtual bool should_close() = 0;
+
+    virtual void close() = 0;
+
+    virtual void focus() = 0;
+
+    // resize, show and focus the window, and clear the close request
+    virtual void show(int width, int height) = 0;
+
+    virtual void hide() = 0;
+
+    virtual void show_cursor(bool visible) = 0;
+
+    virtual bool gamepad_state(int joystick, GLFWgamepadstate& state) = 0;
+
+    virtual const char* gamepad_guid(int joystick) = 0;
+};
+
+// Desktop window with an OpenGL 3.3 context.
+struct GlfwPlatform : public Platform
+{
+    bool init(Application& app) override;
+    void shutdown() override;
+    void new_frame() override;
+    void present() override;
+    bool swap_interval(int interval) override;
+    int  refresh_rate() override;
+    void wait(double timeout) override;
+    void wake() override;
+    void framebuffer_size(int& width, int& height) override;
+    void content_scale(float& xscale, float& yscale) override;
+    bool should_close() override;
+    void close() override;
+    void focus() override;
+    void show(int width, int height) override;
+    void hide() override;
+    void show_cursor(bool visible) override;
+    bool gamepad_state(int joystick, GLFWgamepadstate& state) override;
+    const char* gamepad_guid(int joystick) override;
+
+    GLFWwindow* window = nullptr;
+};
+
+// No window and no input, frames are paced by a fixed timestep.
+// Runs a fixed number of frames and reports frame times on shutdown.
+struct NullPlatform : public Platform
+{
+    using Clock = std::chrono::steady_clock;
+
+    explicit NullPlatform(uint64_t frames, float timestep = 1.0f / 60.0f);
+
+    bool init(Application& app) override;
+    void shutdown() override;
+    void new_frame() override;
+    void present() override;
+    bool swap_interval(int interval) override;
+    int  refresh_rate() override;
+    void wait(double timeout) override;
+    void wake() override;
+    void framebuffer_size(int& width, int& height) override;
+    void content_scale(float& xscale, float& yscale) override;
+    bool should_close() override;
+    void close() override;
+    void focus() override;
+    void show(int width, int height) override;
+    void hide() override;
+    void show_cursor(bool visible) override;
+    bool gamepad_state(int joystick, GLFWgamepadstate& state) override;
+    const char* gamepad_guid(int joystick) override;
+
+    // frame times as CSV, one row per frame
+    bool save(const std::string& path) const;
+
+    uint64_t           frame_limit = 0;
+    uint64_t           frame       = 0;
+    float              timestep    = 1.0f / 60.0f;
+    int                width       = 0;
+    int                height      = 0;
+    bool               closed      = false;
+    Clock::time_point  last{};
+    std::vector<float> frame_times{};
+};
+
+#endif // PLATFORM_H
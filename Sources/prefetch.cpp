@@ -0,0 +1,166 @@
+#include <memory>
+#include <filesystem>
+
+#include <Windows.h>
+
+#include "logger.h"
+#include "prefetch.h"
+
+// no more than this is read per app, game folders can be far larger than the file cache
+static constexpr uint64_t PREFETCH_LIMIT = 4ull << 30;
+static constexpr DWORD    PREFETCH_CHUNK = 1u << 20;
+
+static double to_mib(uint64_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+Prefetcher::~Prefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping  = true;
+        cancelled = true;
+        pending.reset();
+    }
+    wake.notify_one();
+    if (thread.joinable())
+        thread.join();
+}
+
+void Prefetcher::start(const std::vector<std::string>& paths)
+{
+    if (paths.empty()) {
+        cancel();
+        return;
+    }
+
+    // the UI thread never waits for a read or a directory walk in flight, the worker picks the list up when it stops
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        pending   = paths;
+        done      = false;
+        if (!thread.joinable())
+            thread = std::thread(&Prefetcher::work, this);
+    }
+    wake.notify_one();
+}
+
+void Prefetcher::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    pending.reset();
+    done = !busy;
+}
+
+void Prefetcher::work()
+{
+    // lowers both CPU and I/O priority, the UI and a running stream come first
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || pending; });
+        if (stopping)
+            break;
+
+        auto paths = std::move(*pending);
+        pending.reset();
+        cancelled = false;
+        busy      = true;
+        bytes     = 0;
+        total     = 0;
+        files     = 0;
+        read_time = 0;
+
+        lock.unlock();
+        run(paths);
+        lock.lock();
+
+        busy = false;
+        done = !pending;
+    }
+}
+
+void Prefetcher::report(const std::string& name)
+{
+    if (total == 0)
+        return;
+
+    // the time spent reading in the background is what the app would have spent on cold reads
+    Logger::info("{}: {:.1f} of {:.1f} MiB prefetched ({} files), about {} ms of cold reads saved",
+        name, to_mib(bytes), to_mib(total), files.load(), read_time / 1000);
+}
+
+void Prefetcher::run(const std::vector<std::string>& paths)
+{
+    // files of the list, directories expanded, a large game folder takes a while to walk
+    std::vector<std::pair<std::string, uint64_t>> entries{};
+    for (const auto& path : paths) {
+        if (cancelled)
+            break;
+
+        std::error_code ec;
+        if (std::filesystem::is_directory(path, ec)) {
+            for (auto it = std::filesystem::recursive_directory_iterator(path, ec); !ec && !cancelled && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+                if (it->is_regular_file(ec))
+                    entries.emplace_back(it->path().string(), it->file_size(ec));
+            }
+        } else if (std::filesystem::is_regular_file(path, ec)) {
+            entries.emplace_back(path, std::filesystem::file_size(path, ec));
+        } else {
+            Logger::error("Prefetch path {} not found!", path);
+        }
+    }
+
+    uint64_t size = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (size + entries[i].second > PREFETCH_LIMIT) {
+            entries.resize(i);
+            break;
+        }
+        size += entries[i].second;
+    }
+    total = size;
+
+    auto buffer = std::make_unique<char[]>(PREFETCH_CHUNK);
+    auto begin  = Clock::now();
+    for (const auto& [path, file_size] : entries) {
+        if (cancelled)
+            break;
+
+        // read before, still in the file cache unless the system needed the memory
+        auto it = warm.find(path);
+        if (it != warm.end()) {
+            bytes += file_size;
+            read_time += it->second;
+            files++;
+            continue;
+        }
+
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            continue;
+
+        auto  start = Clock::now();
+        DWORD read  = 0;
+        while (!cancelled && ReadFile(file, buffer.get(), PREFETCH_CHUNK, &read, NULL) && read > 0) {
+            bytes += read;
+            bytes_all += read;
+        }
+        CloseHandle(file);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        read_time += elapsed;
+        if (!cancelled) {
+            warm[path] = elapsed;
+            files++;
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count();
+    Logger::info("Prefetched {} files, {:.1f} MiB in {} ms{}", files.load(), to_mib(bytes), elapsed, cancelled ? " (cancelled)" : "");
+}
@@ -0,0 +1,55 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <condition_variable>
+
+// Reads an app's files into the OS file cache on a background-priority thread,
+// so a launch right after finds them warm.
+struct Prefetcher
+{
+    using Clock = std::chrono::steady_clock;
+
+    ~Prefetcher();
+
+    // hand `paths` (files or directories) to the worker, the previous prefetch stops at its next check, does not block
+    void start(const std::vector<std::string>& paths);
+
+    // drop the pending list and ask the running prefetch to stop at its next check, does not block
+    void cancel();
+
+    // log what was warm at launch and the estimated time saved
+    void report(const std::string& name);
+
+    bool running() const { return !done; }
+
+    std::atomic<uint64_t> bytes{0};      // read by the current prefetch
+    std::atomic<uint64_t> total{0};      // size of the current file list
+    std::atomic<uint64_t> files{0};      // completed by the current prefetch
+    std::atomic<int64_t>  read_time{0};  // microseconds spent reading
+    std::atomic<uint64_t> bytes_all{0};  // read since startup
+
+private:
+    void work();
+
+    void run(const std::vector<std::string>& paths);
+
+    std::thread                             thread{};
+    std::mutex                              mutex{};
+    std::condition_variable                 wake{};
+    std::optional<std::vector<std::string>> pending{}; // next list for the worker, guarded by mutex
+    bool                                    busy     = false; // worker inside run(), guarded by mutex
+    bool                                    stopping = false; // guarded by mutex
+    std::atomic<bool>                       cancelled{false};
+    std::atomic<bool>                       done{true};
+    std::unordered_map<std::string, int64_t> warm{}; // fully read files and their read time, worker owned
+};
+
+#endif // PREFETCH_H
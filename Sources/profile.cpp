@@ -0,0 +1,131 @@
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+
+#define TOML_EXCEPTIONS 0
+#include <toml++/toml.hpp>
+
+#include "path.h"
+#include "logger.h"
+#include "profile.h"
+
+static std::string read_env(const char* env)
+{
+    size_t required_size = 0;
+    getenv_s(&required_size, nullptr, 0, env);
+    if (required_size == 0) return "";
+
+    std::string value(required_size, '\0');
+    getenv_s(&required_size, &value[0], required_size, env);
+    value.resize(required_size - 1);
+    return value;
+}
+
+std::string client_key()
+{
+    std::string name   = read_env("SUNSHINE_CLIENT_NAME");
+    std::string width  = read_env("SUNSHINE_CLIENT_WIDTH");
+    std::string height = read_env("SUNSHINE_CLIENT_HEIGHT");
+    std::string fps    = read_env("SUNSHINE_CLIENT_FPS");
+    std::string hdr    = read_env("SUNSHINE_CLIENT_HDR");
+
+    // not started by Sunshine
+    if (width.empty() || height.empty())
+        return "";
+
+    std::stringstream ss;
+    if (!name.empty())
+        ss << name << " ";
+    ss << width << "x" << height << "@" << (fps.empty() ? "60" : fps);
+    if (hdr == "true" || hdr == "1")
+        ss << " hdr";
+    return ss.str();
+}
+
+bool ProfileCache::load(const std::filesystem::path& path)
+{
+    profiles.clear();
+    if (!std::filesystem::exists(path))
+        return true;
+
+    toml::parse_result result = toml::parse_file(path.string());
+    if (!result) {
+        Logger::error("Failed to parse client profiles {}!", path.string());
+        return false;
+    }
+
+    toml::table table = std::move(result).table();
+    if (auto* list = table["profiles"].as_array()) {
+        for (auto& elem : *list) {
+            auto* item = elem.as_table();
+            if (!item)
+                continue;
+
+            ClientProfile profile{};
+            profile.client    = (*item)["client"].value_or<std::string>("");
+            profile.width     = (*item)["width"].value_or(0);
+            profile.height    = (*item)["height"].value_or(0);
+            profile.frequency = (*item)["freq"].value_or(0);
+            profile.scale     = (*item)["scale"].value_or(1.0f);
+            profile.app       = (*item)["app"].value_or<std::string>("");
+            profile.hits      = (*item)["hits"].value_or(0);
+
+            // sanity check
+            if (profile.client.empty() || profile.width <= 0 || profile.height <= 0)
+                continue;
+            profiles.push_back(profile);
+        }
+    }
+    return true;
+}
+
+bool ProfileCache::save(const std::filesystem::path& path) const
+{
+    toml::array list{};
+    for (const auto& profile : profiles) {
+        list.push_back(toml::table{
+            {"client", profile.client},
+            {"width", profile.width},
+            {"height", profile.height},
+            {"freq", profile.frequency},
+            {"scale", profile.scale},
+            {"app", profile.app},
+            {"hits", profile.hits},
+        });
+    }
+
+    toml::table table{};
+    table.insert("profiles", std::move(list));
+
+    std::stringstream ss;
+    ss << table << "\n";
+    if (!write_file_atomic(path, ss.str())) {
+        Logger::error("Failed to write client profiles to {} ({})!", path.string(), GetLastError());
+        return false;
+    }
+    return true;
+}
+
+const ClientProfile* ProfileCache::find(const std::string& client) const
+{
+    auto it = std::find_if(profiles.begin(), profiles.end(), [&](const ClientProfile& profile) { return profile.client == client; });
+    return it != profiles.end() ? &*it : nullptr;
+}
+
+const ClientProfile& ProfileCache::record(const ClientProfile& session)
+{
+    auto it = std::find_if(profiles.begin(), profiles.end(), [&](const ClientProfile& profile) { return profile.client == session.client; });
+    if (it == profiles.end()) {
+        profiles.push_back(session);
+        profiles.back().hits = 1;
+        return profiles.back();
+    }
+
+    bool same = it->width == session.width && it->height == session.height && it->frequency == session.frequency &&
+                it->scale == session.scale && it->app == session.app;
+    int  hits = same ? it->hits + 1 : 1;
+
+    *it      = session;
+    it->hits = hits;
+    return *it;
+}
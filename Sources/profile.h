@@ -0,0 +1,40 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+// Last mode and app picked by one client, keyed on what Sunshine tells about it.
+struct ClientProfile
+{
+    std::string client = "";
+
+    int   width     = 0;
+    int   height    = 0;
+    int   frequency = 0;
+    float scale     = 1.0f;
+
+    std::string app  = "";
+    int         hits = 0; // sessions in a row with the same mode and app
+};
+
+// SUNSHINE_CLIENT_NAME (when set), extent, fps and HDR, e.g. "TV 3840x2160@60 hdr"
+std::string client_key();
+
+// Profiles of every client seen, persisted as profiles.toml.
+struct ProfileCache
+{
+    bool load(const std::filesystem::path& path);
+
+    bool save(const std::filesystem::path& path) const;
+
+    const ClientProfile* find(const std::string& client) const;
+
+    // count a session of `client`, the streak restarts when mode or app differ
+    const ClientProfile& record(const ClientProfile& session);
+
+    std::vector<ClientProfile> profiles{};
+};
+
+#endif // PROFILE_H
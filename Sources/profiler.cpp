@@ -0,0 +1,194 @@
+#include <cstdio>
+#include <algorithm>
+#include <imgui.h>
+
+#include "opengl.h"
+#include "profiler.h"
+
+using Profiler = BasicFrameProfiler<true>;
+
+static const char* phase_names[PROFILER_PHASE_COUNT] = {
+    "NewFrame",
+    "Gamepad",
+    "Tick",
+    "Render",
+    "Clear",
+    "Submit",
+    "Swap",
+    "Poll",
+};
+
+static float elapsed_ms(Profiler::Clock::time_point start, Profiler::Clock::time_point end)
+{
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+// ---------------------------------------------------------------------------
+
+Profiler::Scope::Scope(Profiler* profiler, FramePhase phase) : profiler(profiler), phase(phase)
+{
+    profiler->begin_gpu(phase);
+    start = Clock::now();
+}
+
+Profiler::Scope::~Scope()
+{
+    auto end = Clock::now();
+    profiler->end_gpu(phase);
+
+    auto& frame = profiler->frames[profiler->frame % PROFILER_FRAME_COUNT];
+    frame.cpu_ms[static_cast<size_t>(phase)] += elapsed_ms(start, end);
+}
+
+// ---------------------------------------------------------------------------
+
+void Profiler::init()
+{
+    auto& gl = gl_extensions();
+    gl.load();
+
+    gpu_timers = gl.has_timer_queries();
+    if (gpu_timers) {
+        for (auto& set : queries)
+            gl.GenQueries(static_cast<GLsizei>(set.size()), set.data());
+    }
+}
+
+void Profiler::shutdown()
+{
+    if (gpu_timers) {
+        for (auto& set : queries)
+            gl_extensions().DeleteQueries(static_cast<GLsizei>(set.size()), set.data());
+    }
+    gpu_timers = false;
+}
+
+void Profiler::begin_frame()
+{
+    frame_start = Clock::now();
+
+    auto& current = frames[frame % PROFILER_FRAME_COUNT];
+    current       = Frame{};
+    current.gpu_ms.fill(-1.0f);
+
+    // read back the queries issued PROFILER_GPU_LATENCY frames ago before reusing them
+    if (gpu_timers) {
+        size_t slot = frame % PROFILER_GPU_LATENCY;
+        collect_gpu(slot);
+        query_frames[slot] = frame;
+    }
+}
+
+void Profiler::end_frame()
+{
+    auto& current    = frames[frame % PROFILER_FRAME_COUNT];
+    current.total_ms = elapsed_ms(frame_start, Clock::now());
+
+    totals[frame % PROFILER_FRAME_COUNT] = current.total_ms;
+    frame++;
+}
+
+void Profiler::render()
+{
+    if (!visible)
+        return;
+
+    // averages over completed frames only
+    size_t count = static_cast<size_t>(std::min<uint64_t>(frame, PROFILER_FRAME_COUNT));
+
+    std::array<float, PROFILER_PHASE_COUNT> cpu_avg{};
+    std::array<float, PROFILER_PHASE_COUNT> gpu_avg{};
+    std::array<int, PROFILER_PHASE_COUNT>   gpu_count{};
+    for (size_t i = 1; i <= count; i++) {
+        const auto& f = frames[(frame - i) % PROFILER_FRAME_COUNT];
+        for (size_t p = 0; p < PROFILER_PHASE_COUNT; p++) {
+            cpu_avg[p] += f.cpu_ms[p] / count;
+            if (f.gpu_ms[p] >= 0.0f) {
+                gpu_avg[p] += f.gpu_ms[p];
+                gpu_count[p]++;
+            }
+        }
+    }
+
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - 16.0f, 16.0f), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.85f);
+
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+    if (ImGui::Begin("Frame Profiler", &visible, flags)) {
+        float last = count > 0 ? totals[(frame - 1) % PROFILER_FRAME_COUNT] : 0.0f;
+
+        char overlay[32];
+        std::snprintf(overlay, sizeof(overlay), "%.2f ms", last);
+        ImGui::PlotLines("##frame-times", totals.data(), static_cast<int>(totals.size()),
+            static_cast<int>(frame % PROFILER_FRAME_COUNT), overlay, 0.0f, 33.3f, ImVec2(480, 120));
+
+        if (ImGui::BeginTable("Phases##profiler", 3)) {
+            ImGui::TableSetupColumn("Phase");
+            ImGui::TableSetupColumn("CPU (ms)");
+            ImGui::TableSetupColumn("GPU (ms)");
+            ImGui::TableHeadersRow();
+
+            for (size_t p = 0; p < PROFILER_PHASE_COUNT; p++) {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("%s", phase_names[p]);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%.3f", cpu_avg[p]);
+                ImGui::TableSetColumnIndex(2);
+                if (gpu_count[p] > 0) {
+                    ImGui::Text("%.3f", gpu_avg[p] / gpu_count[p]);
+                } else {
+                    ImGui::TextUnformatted("-");
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
+bool Profiler::is_gpu_phase(FramePhase phase)
+{
+    return phase == FramePhase::Clear || phase == FramePhase::Submit;
+}
+
+void Profiler::begin_gpu(FramePhase phase)
+{
+    if (!gpu_timers || !is_gpu_phase(phase))
+        return;
+
+    size_t slot = frame % PROFILER_GPU_LATENCY;
+    size_t p    = static_cast<size_t>(phase);
+    gl_extensions().BeginQuery(GL_TIME_ELAPSED, queries[slot][p]);
+    query_masks[slot] |= 1u << p;
+}
+
+void Profiler::end_gpu(FramePhase phase)
+{
+    if (!gpu_timers || !is_gpu_phase(phase))
+        return;
+
+    gl_extensions().EndQuery(GL_TIME_ELAPSED);
+}
+
+void Profiler::collect_gpu(size_t slot)
+{
+    auto& gl     = gl_extensions();
+    auto& target = frames[query_frames[slot] % PROFILER_FRAME_COUNT];
+
+    for (size_t p = 0; p < PROFILER_PHASE_COUNT; p++) {
+        if (!(query_masks[slot] & (1u << p)))
+            continue;
+
+        // drop the sample rather than stall the pipeline
+        GLint available = 0;
+        gl.GetQueryObjectiv(queries[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64_t ns = 0;
+            gl.GetQueryObjectui64v(queries[slot][p], GL_QUERY_RESULT, &ns);
+            target.gpu_ms[p] = static_cast<float>(ns) / 1.0e6f;
+        }
+    }
+    query_masks[slot] = 0;
+}
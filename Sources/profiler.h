@@ -0,0 +1,115 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <chrono>
+
+using uint = uint32_t;
+
+enum class FramePhase
+{
+    NewFrame = 0,
+    Gamepad,
+    Tick,
+    Render,
+    Clear,
+    Submit,
+    Swap,
+    Poll,
+    Count,
+};
+
+constexpr size_t PROFILER_PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+constexpr size_t PROFILER_FRAME_COUNT = 240; // frames kept in history
+constexpr size_t PROFILER_GPU_LATENCY = 4;   // frames before reading back GL queries
+
+#ifdef NDEBUG
+constexpr bool PROFILER_ENABLED = false;
+#else
+constexpr bool PROFILER_ENABLED = true;
+#endif
+
+// Disabled profiler, every call compiles to nothing.
+template <bool Enabled>
+struct BasicFrameProfiler
+{
+    static constexpr bool enabled = false;
+
+    struct Scope
+    {
+        ~Scope() {}
+    };
+
+    void init() {}
+    void shutdown() {}
+    void begin_frame() {}
+    void end_frame() {}
+    void render() {}
+
+    Scope scope(FramePhase) { return Scope{}; }
+
+    bool visible = false;
+};
+
+// Per-phase CPU timers plus optional GL timer queries for the GPU phases.
+template <>
+struct BasicFrameProfiler<true>
+{
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr bool enabled = true;
+
+    struct Frame
+    {
+        std::array<float, PROFILER_PHASE_COUNT> cpu_ms{};
+        std::array<float, PROFILER_PHASE_COUNT> gpu_ms{}; // negative when not measured
+        float                                   total_ms = 0.0f;
+    };
+
+    struct Scope
+    {
+        Scope(BasicFrameProfiler* profiler, FramePhase phase);
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+        BasicFrameProfiler* profiler;
+        FramePhase          phase;
+        Clock::time_point   start;
+    };
+
+    // requires a current GL context
+    void init();
+    void shutdown();
+
+    void begin_frame();
+    void end_frame();
+    void render();
+
+    Scope scope(FramePhase phase) { return Scope(this, phase); }
+
+    bool visible = false;
+
+private:
+    static bool is_gpu_phase(FramePhase phase);
+
+    void begin_gpu(FramePhase phase);
+    void end_gpu(FramePhase phase);
+    void collect_gpu(size_t slot);
+
+    std::array<Frame, PROFILER_FRAME_COUNT> frames{};
+    std::array<float, PROFILER_FRAME_COUNT> totals{};
+    Clock::time_point                       frame_start{};
+    uint64_t                                frame = 0;
+
+    using QuerySet = std::array<uint, PROFILER_PHASE_COUNT>;
+
+    bool                                       gpu_timers = false;
+    std::array<QuerySet, PROFILER_GPU_LATENCY> queries{};
+    std::array<uint64_t, PROFILER_GPU_LATENCY> query_frames{};
+    std::array<uint, PROFILER_GPU_LATENCY>     query_masks{}; // phases issued per slot
+};
+
+using FrameProfiler = BasicFrameProfiler<PROFILER_ENABLED>;
+
+#endif // PROFILER_H
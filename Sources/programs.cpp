@@ -0,0 +1,286 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "path.h"
+
+// the backend calls GL through imgl3w's function table, the hooks replace its entries
+#include <imgui_impl_opengl3_loader.h>
+
+#define GLFW_INCLUDE_NONE
+#include "logger.h"
+#include "opengl.h"
+#include "programs.h"
+
+// clang-format off
+static constexpr char     cache_magic[4] = {'M', 'L', 'P', 'C'};
+static constexpr uint32_t cache_version  = 1;
+// clang-format on
+
+// FNV-1a
+static constexpr uint64_t hash_seed = 0xcbf29ce484222325ull;
+
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+
+struct ShaderState
+{
+    uint64_t sources = 0;     // hash of the source strings
+    bool     pending = false; // compile deferred to link time
+};
+
+// hook state, the backend only calls GL from the render thread
+static ProgramCache*                                   installed_cache = nullptr;
+static std::unordered_map<GLuint, ShaderState>         shaders{};
+static std::unordered_map<GLuint, std::vector<GLuint>> attached{};
+
+// the backend's original entry points
+static PFNGLSHADERSOURCEPROC  shader_source  = nullptr;
+static PFNGLCOMPILESHADERPROC compile_shader = nullptr;
+static PFNGLGETSHADERIVPROC   get_shaderiv   = nullptr;
+static PFNGLATTACHSHADERPROC  attach_shader  = nullptr;
+static PFNGLLINKPROGRAMPROC   link_program   = nullptr;
+
+static void APIENTRY hooked_shader_source(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+{
+    uint64_t hash = hash_seed;
+    for (GLsizei i = 0; i < count; i++)
+        hash = hash_bytes(hash, strings[i], lengths && lengths[i] >= 0 ? static_cast<size_t>(lengths[i]) : std::strlen(strings[i]));
+    shaders[shader].sources = hash;
+    shader_source(shader, count, strings, lengths);
+}
+
+static void APIENTRY hooked_compile_shader(GLuint shader)
+{
+    shaders[shader].pending = true;
+}
+
+static void APIENTRY hooked_get_shaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    // deferred compiles look successful, errors surface in the link log instead
+    auto it = shaders.find(shader);
+    if (it != shaders.end() && it->second.pending && (pname == GL_COMPILE_STATUS || pname == GL_INFO_LOG_LENGTH)) {
+        *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+        return;
+    }
+    get_shaderiv(shader, pname, params);
+}
+
+static void APIENTRY hooked_attach_shader(GLuint program, GLuint shader)
+{
+    attached[program].push_back(shader);
+    attach_shader(program, shader);
+}
+
+static void APIENTRY hooked_link_program(GLuint program)
+{
+    uint64_t hash = hash_seed;
+    for (GLuint shader : attached[program])
+        hash = hash_bytes(hash, &shaders[shader].sources, sizeof(uint64_t));
+    installed_cache->link(program, hash);
+}
+
+// ---------------------------------------------------------------------------
+
+bool ProgramCache::install()
+{
+    auto& gl = gl_extensions();
+    gl.load();
+    if (!gl.has_program_binaries())
+        return false;
+
+    // a driver may support the extension with no binary formats at all
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0)
+        return false;
+
+    auto text = [](GLenum name) {
+        auto value = glGetString(name);
+        return std::string(value ? reinterpret_cast<const char*>(value) : "");
+    };
+    driver = text(GL_VENDOR) + "|" + text(GL_RENDERER) + "|" + text(GL_VERSION);
+    load();
+
+    shader_source  = imgl3wProcs.gl.ShaderSource;
+    compile_shader = imgl3wProcs.gl.CompileShader;
+    get_shaderiv   = imgl3wProcs.gl.GetShaderiv;
+    attach_shader  = imgl3wProcs.gl.AttachShader;
+    link_program   = imgl3wProcs.gl.LinkProgram;
+
+    imgl3wProcs.gl.ShaderSource  = hooked_shader_source;
+    imgl3wProcs.gl.CompileShader = hooked_compile_shader;
+    imgl3wProcs.gl.GetShaderiv   = hooked_get_shaderiv;
+    imgl3wProcs.gl.AttachShader  = hooked_attach_shader;
+    imgl3wProcs.gl.LinkProgram   = hooked_link_program;
+
+    installed_cache = this;
+    active          = true;
+    return true;
+}
+
+void ProgramCache::uninstall()
+{
+    if (!active)
+        return;
+
+    imgl3wProcs.gl.ShaderSource  = shader_source;
+    imgl3wProcs.gl.CompileShader = compile_shader;
+    imgl3wProcs.gl.GetShaderiv   = get_shaderiv;
+    imgl3wProcs.gl.AttachShader  = attach_shader;
+    imgl3wProcs.gl.LinkProgram   = link_program;
+
+    shaders.clear();
+    attached.clear();
+    installed_cache = nullptr;
+    active          = false;
+
+    Logger::info("Program cache: {} loaded, {} compiled", hits, misses);
+    if (dirty)
+        save();
+}
+
+void ProgramCache::link(uint32_t program, uint64_t sources)
+{
+    auto& gl     = gl_extensions();
+    GLint status = GL_FALSE;
+
+    // the attached shaders are ignored when a binary loads, their compiles are never needed
+    if (auto it = binaries.find(sources); it != binaries.end()) {
+        const auto& binary = it->second;
+        gl.ProgramBinary(program, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+        imgl3wProcs.gl.GetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status == GL_TRUE) {
+            hits++;
+            return;
+        }
+
+        // e.g. a driver update that kept its version string
+        Logger::warn("Cached program binary rejected, recompiling");
+        binaries.erase(it);
+        dirty = true;
+    }
+
+    for (GLuint shader : attached[program]) {
+        auto& state = shaders[shader];
+        if (state.pending)
+            compile_shader(shader);
+        state.pending = false;
+    }
+    gl.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    link_program(program);
+    misses++;
+
+    GLint length = 0;
+    imgl3wProcs.gl.GetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_TRUE)
+        imgl3wProcs.gl.GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    Binary  binary{};
+    GLsizei written = 0;
+    GLenum  format  = 0;
+    binary.data.resize(length);
+    gl.GetProgramBinary(program, length, &written, &format, binary.data.data());
+    if (written <= 0)
+        return;
+
+    binary.format = format;
+    binary.data.resize(written);
+    binaries[sources] = std::move(binary);
+    dirty             = true;
+}
+
+// ---------------------------------------------------------------------------
+
+template <typename T>
+static bool read_value(const std::string& data, size_t& offset, T& value)
+{
+    if (data.size() - offset < sizeof(T))
+        return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+template <typename T>
+static void write_value(std::string& data, const T& value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool ProgramCache::load()
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // magic, version, driver, count, then key, format, size and data per binary
+    size_t   offset  = 0;
+    uint32_t version = 0;
+    uint32_t length  = 0;
+    uint32_t count   = 0;
+    if (data.size() < sizeof(cache_magic) || std::memcmp(data.data(), cache_magic, sizeof(cache_magic)) != 0)
+        return false;
+    offset += sizeof(cache_magic);
+    if (!read_value(data, offset, version) || version != cache_version || !read_value(data, offset, length) || data.size() - offset < length)
+        return false;
+
+    // binaries only load into the driver that produced them
+    if (data.compare(offset, length, driver) != 0 || length != driver.size()) {
+        Logger::info("Program cache {} is from another driver, ignored", path);
+        return false;
+    }
+    offset += length;
+
+    if (!read_value(data, offset, count))
+        return false;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t key  = 0;
+        Binary   binary{};
+        uint32_t size = 0;
+        if (!read_value(data, offset, key) || !read_value(data, offset, binary.format) || !read_value(data, offset, size) || data.size() - offset < size) {
+            Logger::warn("Program cache {} is truncated!", path);
+            binaries.clear();
+            return false;
+        }
+        binary.data.assign(data.begin() + offset, data.begin() + offset + size);
+        offset += size;
+        binaries[key] = std::move(binary);
+    }
+
+    Logger::debug("Loaded {} program binaries from {}", binaries.size(), path);
+    return true;
+}
+
+bool ProgramCache::save() const
+{
+    std::string data(cache_magic, sizeof(cache_magic));
+    write_value(data, cache_version);
+    write_value(data, static_cast<uint32_t>(driver.size()));
+    data += driver;
+    write_value(data, static_cast<uint32_t>(binaries.size()));
+    for (const auto& [key, binary] : binaries) {
+        write_value(data, key);
+        write_value(data, binary.format);
+        write_value(data, static_cast<uint32_t>(binary.data.size()));
+        data.append(reinterpret_cast<const char*>(binary.data.data()), binary.data.size());
+    }
+
+    if (!write_file_atomic(path, data)) {
+        Logger::error("Failed to write program cache {}!", path);
+        return false;
+    }
+    return true;
+}
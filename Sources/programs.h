@@ -0,0 +1,44 @@
+#ifndef PROGRAMS_H
+#define PROGRAMS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+// Linked programs of ImGui's OpenGL 3 backend, kept as program binaries between runs.
+// While installed, the backend's shader calls go through the cache: compiles are deferred
+// to link time and skipped when a binary for the same sources and driver loads.
+struct ProgramCache
+{
+    struct Binary
+    {
+        uint32_t             format = 0;
+        std::vector<uint8_t> data{};
+    };
+
+    // after ImGui_ImplOpenGL3_Init(), before the backend creates its device objects,
+    // false when the driver cannot return program binaries
+    bool install();
+
+    // restore the backend's entry points and save new binaries, once its program is linked
+    void uninstall();
+
+    bool installed() const { return active; }
+
+    // called through the hooked glLinkProgram
+    void link(uint32_t program, uint64_t sources);
+
+    bool load();
+    bool save() const;
+
+    std::string                          path   = "";
+    std::string                          driver = ""; // GL_VENDOR, GL_RENDERER and GL_VERSION
+    std::unordered_map<uint64_t, Binary> binaries{};  // by hash of the program's shader sources
+    uint32_t                             hits   = 0;
+    uint32_t                             misses = 0;
+    bool                                 dirty  = false;
+    bool                                 active = false;
+};
+
+#endif // PROGRAMS_H
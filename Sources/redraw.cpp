@@ -0,0 +1,96 @@
+#include <cstring>
+
+#include "redraw.h"
+
+static constexpr uint64_t HASH_MULTIPLIER = 0xc6a4a7935bd1e995ull;
+
+static uint64_t hash_mix(uint64_t h, uint64_t k)
+{
+    k *= HASH_MULTIPLIER;
+    k ^= k >> 47;
+    k *= HASH_MULTIPLIER;
+    h ^= k;
+    h *= HASH_MULTIPLIER;
+    return h;
+}
+
+static uint64_t hash_bytes(uint64_t h, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    // 8 bytes at a time, vertex/index buffers dominate the cost
+    for (; size >= 8; size -= 8, bytes += 8) {
+        uint64_t k;
+        std::memcpy(&k, bytes, sizeof(k));
+        h = hash_mix(h, k);
+    }
+
+    uint64_t tail = 0;
+    if (size > 0)
+        std::memcpy(&tail, bytes, size);
+    return hash_mix(h, tail ^ (static_cast<uint64_t>(size) << 56));
+}
+
+template <typename T>
+static uint64_t hash_value(uint64_t h, const T& value)
+{
+    return hash_bytes(h, &value, sizeof(value));
+}
+
+uint64_t hash_draw_data(const ImDrawData* draw_data)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ull;
+    if (!draw_data || !draw_data->Valid)
+        return h;
+
+    h = hash_value(h, draw_data->DisplayPos.x);
+    h = hash_value(h, draw_data->DisplayPos.y);
+    h = hash_value(h, draw_data->DisplaySize.x);
+    h = hash_value(h, draw_data->DisplaySize.y);
+    h = hash_value(h, draw_data->FramebufferScale.x);
+    h = hash_value(h, draw_data->FramebufferScale.y);
+    h = hash_value(h, draw_data->CmdListsCount);
+
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        h = hash_bytes(h, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+        h = hash_bytes(h, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+
+        // hash fields one by one, ImDrawCmd has padding
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            h = hash_value(h, cmd.ClipRect.x);
+            h = hash_value(h, cmd.ClipRect.y);
+            h = hash_value(h, cmd.ClipRect.z);
+            h = hash_value(h, cmd.ClipRect.w);
+            h = hash_value(h, cmd.TextureId);
+            h = hash_value(h, cmd.VtxOffset);
+            h = hash_value(h, cmd.IdxOffset);
+            h = hash_value(h, cmd.ElemCount);
+            h = hash_value(h, cmd.UserCallback);
+            h = hash_value(h, cmd.UserCallbackData);
+        }
+    }
+    return h;
+}
+
+bool RedrawFilter::update(const ImDrawData* draw_data, int width, int height)
+{
+    if (!enabled) {
+        submitted++;
+        return true;
+    }
+
+    uint64_t h = hash_draw_data(draw_data);
+    h          = hash_value(h, width);
+    h          = hash_value(h, height);
+
+    if (valid && h == last_hash) {
+        skipped++;
+        return false;
+    }
+
+    valid     = true;
+    last_hash = h;
+    submitted++;
+    return true;
+}
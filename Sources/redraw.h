@@ -0,0 +1,29 @@
+#ifndef REDRAW_H
+#define REDRAW_H
+
+#include <cstdint>
+#include <imgui.h>
+
+// Hash of everything that affects the rasterized output of the draw data.
+uint64_t hash_draw_data(const ImDrawData* draw_data);
+
+// Detects frames whose draw data is identical to the last submitted one,
+// so clear/submit/swap can be skipped for them.
+struct RedrawFilter
+{
+    // returns true if the frame has to be submitted
+    bool update(const ImDrawData* draw_data, int width, int height);
+
+    // force the next frame to be submitted (e.g. texture contents changed)
+    void invalidate() { valid = false; }
+
+    bool     enabled   = true;
+    uint64_t submitted = 0;
+    uint64_t skipped   = 0;
+
+private:
+    bool     valid     = false;
+    uint64_t last_hash = 0;
+};
+
+#endif // REDRAW_H
@@ -0,0 +1,318 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <imgui_impl_opengl3.h>
+
+#include "logger.h"
+#include "opengl.h"
+#include "renderer.h"
+
+// ---------------------------------------------------------------------------
+
+OpenGLRenderer::OpenGLRenderer(std::string program_cache)
+{
+    programs.path = std::move(program_cache);
+}
+
+bool OpenGLRenderer::init()
+{
+    if (!ImGui_ImplOpenGL3_Init("#version 150")) {
+        Logger::error("[ImGui] Failed to initialize OpenGL3!");
+        return false;
+    }
+
+    // the backend compiles its shaders on the first new frame
+    if (!programs.path.empty() && !programs.install())
+        Logger::debug("No program binary support, shaders are compiled every run");
+    return true;
+}
+
+void OpenGLRenderer::shutdown()
+{
+    programs.uninstall();
+    ImGui_ImplOpenGL3_Shutdown();
+}
+
+void OpenGLRenderer::new_frame()
+{
+    ImGui_ImplOpenGL3_NewFrame();
+
+    // the program is linked by now, later GL calls go straight to the driver
+    if (programs.installed())
+        programs.uninstall();
+}
+
+void OpenGLRenderer::create_fonts_texture()
+{
+    ImGui_ImplOpenGL3_CreateFontsTexture();
+}
+
+void OpenGLRenderer::clear(int width, int height, const ImVec4& color)
+{
+    glViewport(0, 0, width, height);
+    glClearColor(color.x, color.y, color.z, color.w);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void OpenGLRenderer::render(ImDrawData* draw_data)
+{
+    ImGui_ImplOpenGL3_RenderDrawData(draw_data);
+}
+
+ImTextureID OpenGLRenderer::create_texture(int width, int height, const uint32_t* pixels)
+{
+    GLint  last_texture = 0;
+    GLuint texture      = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGenTextures(1, &texture);
+    if (!texture)
+        return nullptr;
+
+    // images are downscaled to the tile size on decode, no mipmaps needed
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(last_texture));
+    return reinterpret_cast<ImTextureID>(static_cast<intptr_t>(texture));
+}
+
+void OpenGLRenderer::destroy_texture(ImTextureID texture)
+{
+    GLuint name = static_cast<GLuint>(reinterpret_cast<intptr_t>(texture));
+    glDeleteTextures(1, &name);
+}
+
+void OpenGLRenderer::finish()
+{
+    glFinish();
+}
+
+// ---------------------------------------------------------------------------
+
+struct RasterVertex
+{
+    float x, y;
+    float u, v;
+    float r, g, b, a; // 0-1
+};
+
+static RasterVertex to_raster_vertex(const ImDrawVert& vert, const ImVec2& offset, const ImVec2& scale)
+{
+    RasterVertex rv;
+    rv.x = (vert.pos.x - offset.x) * scale.x;
+    rv.y = (vert.pos.y - offset.y) * scale.y;
+    rv.u = vert.uv.x;
+    rv.v = vert.uv.y;
+    rv.r = ((vert.col >> IM_COL32_R_SHIFT) & 0xFF) / 255.0f;
+    rv.g = ((vert.col >> IM_COL32_G_SHIFT) & 0xFF) / 255.0f;
+    rv.b = ((vert.col >> IM_COL32_B_SHIFT) & 0xFF) / 255.0f;
+    rv.a = ((vert.col >> IM_COL32_A_SHIFT) & 0xFF) / 255.0f;
+    return rv;
+}
+
+static float edge(const RasterVertex& a, const RasterVertex& b, float x, float y)
+{
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+static void rasterize(std::vector<uint32_t>& framebuffer, int width,
+    const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2,
+    const SoftwareRenderer::Texture* texture, int clip_x0, int clip_y0, int clip_x1, int clip_y1)
+{
+    float area = edge(v0, v1, v2.x, v2.y);
+    if (std::fabs(area) < 1e-6f)
+        return;
+
+    int x0 = std::max(clip_x0, static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))));
+    int y0 = std::max(clip_y0, static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))));
+    int x1 = std::min(clip_x1, static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))));
+    int y1 = std::min(clip_y1, static_cast<int>(std::ceil(std::max({v0.y, v1.y, v2.y}))));
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    // edge functions are affine, step them across the bounding box
+    const float inv_area = 1.0f / area;
+    const float dw0_dx   = -(v2.y - v1.y) * inv_area;
+    const float dw1_dx   = -(v0.y - v2.y) * inv_area;
+    const float dw2_dx   = -(v1.y - v0.y) * inv_area;
+
+    for (int y = y0; y < y1; y++) {
+        float     py  = y + 0.5f;
+        float     px  = x0 + 0.5f;
+        float     w0  = edge(v1, v2, px, py) * inv_area;
+        float     w1  = edge(v2, v0, px, py) * inv_area;
+        float     w2  = edge(v0, v1, px, py) * inv_area;
+        uint32_t* row = framebuffer.data() + static_cast<size_t>(y) * width;
+
+        for (int x = x0; x < x1; x++, w0 += dw0_dx, w1 += dw1_dx, w2 += dw2_dx) {
+            if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                continue;
+
+            float r = w0 * v0.r + w1 * v1.r + w2 * v2.r;
+            float g = w0 * v0.g + w1 * v1.g + w2 * v2.g;
+            float b = w0 * v0.b + w1 * v1.b + w2 * v2.b;
+            float a = w0 * v0.a + w1 * v1.a + w2 * v2.a;
+
+            if (texture && !texture->pixels.empty()) {
+                float u  = w0 * v0.u + w1 * v1.u + w2 * v2.u;
+                float v  = w0 * v0.v + w1 * v1.v + w2 * v2.v;
+                int   tx = std::clamp(static_cast<int>(u * texture->width), 0, texture->width - 1);
+                int   ty = std::clamp(static_cast<int>(v * texture->height), 0, texture->height - 1);
+
+                uint32_t texel = texture->pixels[static_cast<size_t>(ty) * texture->width + tx];
+                r *= ((texel >> IM_COL32_R_SHIFT) & 0xFF) / 255.0f;
+                g *= ((texel >> IM_COL32_G_SHIFT) & 0xFF) / 255.0f;
+                b *= ((texel >> IM_COL32_B_SHIFT) & 0xFF) / 255.0f;
+                a *= ((texel >> IM_COL32_A_SHIFT) & 0xFF) / 255.0f;
+            }
+
+            if (a <= 0.0f)
+                continue;
+
+            // straight alpha blending, same as the OpenGL backend
+            uint32_t dst = row[x];
+            float    dr  = ((dst >> IM_COL32_R_SHIFT) & 0xFF) / 255.0f;
+            float    dg  = ((dst >> IM_COL32_G_SHIFT) & 0xFF) / 255.0f;
+            float    db  = ((dst >> IM_COL32_B_SHIFT) & 0xFF) / 255.0f;
+            float    da  = ((dst >> IM_COL32_A_SHIFT) & 0xFF) / 255.0f;
+
+            a = std::min(a, 1.0f);
+            r = r * a + dr * (1.0f - a);
+            g = g * a + dg * (1.0f - a);
+            b = b * a + db * (1.0f - a);
+            a = a + da * (1.0f - a);
+
+            row[x] = IM_COL32(
+                static_cast<int>(r * 255.0f + 0.5f),
+                static_cast<int>(g * 255.0f + 0.5f),
+                static_cast<int>(b * 255.0f + 0.5f),
+                static_cast<int>(a * 255.0f + 0.5f));
+        }
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(std::string screenshot) : screenshot(std::move(screenshot)) {}
+
+bool SoftwareRenderer::init()
+{
+    ImGuiIO& io            = ImGui::GetIO();
+    io.BackendRendererName = "software";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    return true;
+}
+
+void SoftwareRenderer::shutdown()
+{
+    if (!screenshot.empty())
+        save(screenshot);
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.Fonts->SetTexID(nullptr);
+    io.BackendRendererName = nullptr;
+}
+
+void SoftwareRenderer::new_frame() {}
+
+void SoftwareRenderer::create_fonts_texture()
+{
+    ImGuiIO& io = ImGui::GetIO();
+
+    unsigned char* pixels = nullptr;
+    int            w = 0, h = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &w, &h);
+
+    font_texture.width  = w;
+    font_texture.height = h;
+    font_texture.pixels.resize(static_cast<size_t>(w) * h);
+    std::memcpy(font_texture.pixels.data(), pixels, font_texture.pixels.size() * sizeof(uint32_t));
+
+    io.Fonts->SetTexID(static_cast<ImTextureID>(&font_texture));
+}
+
+void SoftwareRenderer::clear(int width, int height, const ImVec4& color)
+{
+    this->width  = width;
+    this->height = height;
+    framebuffer.assign(static_cast<size_t>(width) * height, ImGui::ColorConvertFloat4ToU32(color));
+}
+
+void SoftwareRenderer::render(ImDrawData* draw_data)
+{
+    if (!draw_data || width <= 0 || height <= 0)
+        return;
+
+    const ImVec2 offset = draw_data->DisplayPos;
+    const ImVec2 scale  = draw_data->FramebufferScale;
+
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        const ImDrawVert* vtx      = cmd_list->VtxBuffer.Data;
+        const ImDrawIdx*  idx      = cmd_list->IdxBuffer.Data;
+
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            if (cmd.UserCallback) {
+                if (cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                    cmd.UserCallback(cmd_list, &cmd);
+                continue;
+            }
+
+            // clip rectangle in framebuffer space
+            int clip_x0 = std::max(0, static_cast<int>((cmd.ClipRect.x - offset.x) * scale.x));
+            int clip_y0 = std::max(0, static_cast<int>((cmd.ClipRect.y - offset.y) * scale.y));
+            int clip_x1 = std::min(width, static_cast<int>((cmd.ClipRect.z - offset.x) * scale.x));
+            int clip_y1 = std::min(height, static_cast<int>((cmd.ClipRect.w - offset.y) * scale.y));
+            if (clip_x0 >= clip_x1 || clip_y0 >= clip_y1)
+                continue;
+
+            const auto* texture = static_cast<const Texture*>(cmd.GetTexID());
+            for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                RasterVertex v0 = to_raster_vertex(vtx[cmd.VtxOffset + idx[cmd.IdxOffset + i + 0]], offset, scale);
+                RasterVertex v1 = to_raster_vertex(vtx[cmd.VtxOffset + idx[cmd.IdxOffset + i + 1]], offset, scale);
+                RasterVertex v2 = to_raster_vertex(vtx[cmd.VtxOffset + idx[cmd.IdxOffset + i + 2]], offset, scale);
+                rasterize(framebuffer, width, v0, v1, v2, texture, clip_x0, clip_y0, clip_x1, clip_y1);
+            }
+        }
+    }
+}
+
+ImTextureID SoftwareRenderer::create_texture(int width, int height, const uint32_t* pixels)
+{
+    auto* texture   = new Texture();
+    texture->width  = width;
+    texture->height = height;
+    texture->pixels.assign(pixels, pixels + static_cast<size_t>(width) * height);
+    return static_cast<ImTextureID>(texture);
+}
+
+void SoftwareRenderer::destroy_texture(ImTextureID texture)
+{
+    delete static_cast<Texture*>(texture);
+}
+
+void SoftwareRenderer::finish() {}
+
+bool SoftwareRenderer::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file) {
+        Logger::error("Failed to write screenshot to {}!", path);
+        return false;
+    }
+
+    // binary PPM, alpha dropped
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (uint32_t pixel : framebuffer) {
+        char rgb[3] = {
+            static_cast<char>((pixel >> IM_COL32_R_SHIFT) & 0xFF),
+            static_cast<char>((pixel >> IM_COL32_G_SHIFT) & 0xFF),
+            static_cast<char>((pixel >> IM_COL32_B_SHIFT) & 0xFF),
+        };
+        file.write(rgb, sizeof(rgb));
+    }
+
+    Logger::info("Screenshot saved to {}", path);
+    return true;
+}
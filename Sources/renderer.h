@@ -0,0 +1,89 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <imgui.h>
+
+#include "programs.h"
+
+// Draws ImGui draw data into the platform's framebuffer.
+struct Renderer
+{
+    virtual ~Renderer() = default;
+
+    virtual bool init() = 0;
+
+    virtual void shutdown() = 0;
+
+    virtual void new_frame() = 0;
+
+    // upload the font atlas after (re)building it
+    virtual void create_fonts_texture() = 0;
+
+    virtual void clear(int width, int height, const ImVec4& color) = 0;
+
+    virtual void render(ImDrawData* draw_data) = 0;
+
+    // RGBA8 image for ImGui::Image, nullptr on failure
+    virtual ImTextureID create_texture(int width, int height, const uint32_t* pixels) = 0;
+
+    virtual void destroy_texture(ImTextureID texture) = 0;
+
+    // block until the GPU is done with the submitted frames, no frames queued ahead
+    virtual void finish() = 0;
+};
+
+// ImGui's OpenGL 3 backend.
+struct OpenGLRenderer : public Renderer
+{
+    // the backend's linked program is cached in `program_cache` when set
+    explicit OpenGLRenderer(std::string program_cache = "");
+
+    bool init() override;
+    void shutdown() override;
+    void new_frame() override;
+    void create_fonts_texture() override;
+    void clear(int width, int height, const ImVec4& color) override;
+    void render(ImDrawData* draw_data) override;
+    ImTextureID create_texture(int width, int height, const uint32_t* pixels) override;
+    void destroy_texture(ImTextureID texture) override;
+    void finish() override;
+
+    ProgramCache programs{};
+};
+
+// CPU rasterizer into an in-memory RGBA framebuffer, needs no GPU.
+struct SoftwareRenderer : public Renderer
+{
+    struct Texture
+    {
+        int                   width  = 0;
+        int                   height = 0;
+        std::vector<uint32_t> pixels{};
+    };
+
+    // the last frame is written to `screenshot` (PPM) on shutdown
+    explicit SoftwareRenderer(std::string screenshot = "");
+
+    bool init() override;
+    void shutdown() override;
+    void new_frame() override;
+    void create_fonts_texture() override;
+    void clear(int width, int height, const ImVec4& color) override;
+    void render(ImDrawData* draw_data) override;
+    ImTextureID create_texture(int width, int height, const uint32_t* pixels) override;
+    void destroy_texture(ImTextureID texture) override;
+    void finish() override;
+
+    bool save(const std::string& path) const;
+
+    std::string           screenshot = "";
+    int                   width      = 0;
+    int                   height     = 0;
+    std::vector<uint32_t> framebuffer{};
+    Texture               font_texture{};
+};
+
+#endif // RENDERER_H
@@ -0,0 +1,221 @@
+#include <mutex>
+#include <sstream>
+#include <DpiHelper.h>
+
+#define TOML_EXCEPTIONS 0
+#include <toml++/toml.hpp>
+
+#include "path.h"
+#include "logger.h"
+#include "display.h"
+#include "session.h"
+
+static std::mutex journal_mutex;
+static bool       journaled = false; // this process wrote or found the journal
+
+static std::optional<std::filesystem::path> journal_path()
+{
+    auto app_config_path = get_app_config_path(APP_NAME);
+    if (!app_config_path.has_value())
+        return std::nullopt;
+    return std::filesystem::path(app_config_path.value()) / "session.toml";
+}
+
+DisplaySnapshot capture_display_snapshot()
+{
+    DisplaySnapshot snapshot{};
+
+    std::vector<DisplayData> displays = display_topology().data();
+    if (displays.empty())
+        displays.push_back(DisplayData{});
+
+    for (const auto& display : displays) {
+        const char* name = display.m_deviceName.empty() ? NULL : display.m_deviceName.c_str();
+
+        DEVMODEA dm;
+        ZeroMemory(&dm, sizeof(dm));
+        dm.dmSize = sizeof(dm);
+        if (!EnumDisplaySettingsA(name, ENUM_CURRENT_SETTINGS, &dm)) {
+            Logger::error("Could not get current display settings of {}!", display.m_deviceName);
+            continue;
+        }
+
+        DisplaySnapshot::Monitor monitor{};
+        monitor.device    = display.m_deviceName;
+        monitor.width     = dm.dmPelsWidth;
+        monitor.height    = dm.dmPelsHeight;
+        monitor.frequency = dm.dmDisplayFrequency;
+        monitor.scale     = 100;
+        if (display.m_sourceID >= 0)
+            monitor.scale = DpiHelper::GetDPIScalingInfo(display.m_adapterId, display.m_sourceID).current;
+        snapshot.monitors.push_back(monitor);
+    }
+    return snapshot;
+}
+
+bool save_display_snapshot(const std::filesystem::path& path, const DisplaySnapshot& snapshot)
+{
+    toml::array monitors{};
+    for (const auto& monitor : snapshot.monitors) {
+        monitors.push_back(toml::table{
+            {"device", monitor.device},
+            {"width", monitor.width},
+            {"height", monitor.height},
+            {"freq", monitor.frequency},
+            {"scale", monitor.scale},
+        });
+    }
+
+    toml::table table{};
+    table.insert("monitors", std::move(monitors));
+
+    std::stringstream ss;
+    ss << table << "\n";
+    if (!write_file_atomic(path, ss.str())) {
+        Logger::error("Failed to write display journal to {} ({})!", path.string(), GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool load_display_snapshot(const std::filesystem::path& path, DisplaySnapshot& snapshot)
+{
+    toml::parse_result result = toml::parse_file(path.string());
+    if (!result) {
+        Logger::error("Failed to parse display journal {}!", path.string());
+        return false;
+    }
+
+    toml::table table = std::move(result).table();
+    auto*       monitors = table["monitors"].as_array();
+    if (!monitors)
+        return false;
+
+    snapshot.monitors.clear();
+    for (auto& elem : *monitors) {
+        auto* item = elem.as_table();
+        if (!item)
+            continue;
+
+        DisplaySnapshot::Monitor monitor{};
+        monitor.device    = (*item)["device"].value_or<std::string>("");
+        monitor.width     = (*item)["width"].value_or(0);
+        monitor.height    = (*item)["height"].value_or(0);
+        monitor.frequency = (*item)["freq"].value_or(0);
+        monitor.scale     = (*item)["scale"].value_or(100);
+
+        // sanity check
+        if (monitor.width <= 0 || monitor.height <= 0)
+            continue;
+        snapshot.monitors.push_back(monitor);
+    }
+    return !snapshot.monitors.empty();
+}
+
+bool apply_display_snapshot(const DisplaySnapshot& snapshot)
+{
+    display_topology().expect();
+
+    bool success = true;
+    for (const auto& monitor : snapshot.monitors) {
+        const char* name = monitor.device.empty() ? NULL : monitor.device.c_str();
+
+        DEVMODEA dm;
+        ZeroMemory(&dm, sizeof(dm));
+        dm.dmSize = sizeof(dm);
+        if (!EnumDisplaySettingsA(name, ENUM_CURRENT_SETTINGS, &dm)) {
+            Logger::error("Could not get current display settings of {}!", monitor.device);
+            success = false;
+            continue;
+        }
+
+        dm.dmPelsWidth  = monitor.width;
+        dm.dmPelsHeight = monitor.height;
+        dm.dmFields     = DM_PELSWIDTH | DM_PELSHEIGHT;
+        if (monitor.frequency > 0) {
+            dm.dmDisplayFrequency = monitor.frequency;
+            dm.dmFields |= DM_DISPLAYFREQUENCY;
+        }
+
+        // stage the modes, committed together below
+        DWORD flags = CDS_UPDATEREGISTRY | CDS_GLOBAL | CDS_NORESET;
+        if (ChangeDisplaySettingsExA(name, &dm, NULL, flags, NULL) != DISP_CHANGE_SUCCESSFUL) {
+            Logger::error("Display restore failed for {}.", monitor.device);
+            success = false;
+        }
+    }
+
+    if (ChangeDisplaySettingsExA(NULL, NULL, NULL, 0, NULL) != DISP_CHANGE_SUCCESSFUL) {
+        Logger::error("Display restore failed.");
+        return false;
+    }
+
+    // source ids are looked up again, they do not survive a topology change
+    for (const auto& monitor : snapshot.monitors) {
+        std::vector<std::string> monitors{};
+        if (!monitor.device.empty())
+            monitors.push_back(monitor.device);
+
+        for (const auto& display : display_topology().find(monitors)) {
+            if (!DpiHelper::SetDPIScaling(display.m_adapterId, display.m_sourceID, monitor.scale)) {
+                Logger::error("DpiHelper::SetDPIScaling() failed!");
+                success = false;
+            }
+        }
+    }
+
+    // done once the desktop has finished laying out again, not when the calls return
+    display_topology().settle();
+    return success;
+}
+
+void begin_display_session()
+{
+    std::lock_guard<std::mutex> lock(journal_mutex);
+    if (journaled)
+        return;
+
+    auto path = journal_path();
+    if (!path.has_value())
+        return;
+
+    // an existing journal is the state before a session that was never restored
+    if (std::filesystem::exists(path.value())) {
+        Logger::info("Keeping display journal of an earlier session");
+        journaled = true;
+        return;
+    }
+
+    DisplaySnapshot snapshot = capture_display_snapshot();
+    if (snapshot.monitors.empty() || !save_display_snapshot(path.value(), snapshot))
+        return;
+
+    Logger::info("Display state of {} monitors journaled to {}", snapshot.monitors.size(), path->string());
+    journaled = true;
+}
+
+bool restore_display_session()
+{
+    std::lock_guard<std::mutex> lock(journal_mutex);
+
+    auto path = journal_path();
+    if (!path.has_value() || !std::filesystem::exists(path.value())) {
+        Logger::info("No display journal, nothing to restore");
+        return true;
+    }
+
+    DisplaySnapshot snapshot{};
+    if (!load_display_snapshot(path.value(), snapshot))
+        return false;
+
+    // keep the journal for another attempt when the restore fails
+    if (!apply_display_snapshot(snapshot))
+        return false;
+
+    std::error_code ec;
+    std::filesystem::remove(path.value(), ec);
+    journaled = false;
+
+    Logger::info("Display state of {} monitors restored", snapshot.monitors.size());
+    return true;
+}
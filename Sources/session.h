@@ -0,0 +1,40 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+// Display state of every monitor before a session changed it.
+struct DisplaySnapshot
+{
+    struct Monitor
+    {
+        std::string device = ""; // GDI name, the primary display when empty
+        int         width;
+        int         height;
+        int         frequency;
+        int         scale; // percent
+    };
+
+    std::vector<Monitor> monitors{};
+};
+
+DisplaySnapshot capture_display_snapshot();
+
+// written to a temporary file and moved over `path`, never left half written
+bool save_display_snapshot(const std::filesystem::path& path, const DisplaySnapshot& snapshot);
+
+bool load_display_snapshot(const std::filesystem::path& path, DisplaySnapshot& snapshot);
+
+// modes are committed together, then scales; returns once the displays have settled
+bool apply_display_snapshot(const DisplaySnapshot& snapshot);
+
+// journal the current display state unless a session is already journaled,
+// called before every mode or scale change
+void begin_display_session();
+
+// apply and remove the journal, true when there was nothing to restore
+bool restore_display_session();
+
+#endif // SESSION_H
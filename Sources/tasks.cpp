@@ -0,0 +1,84 @@
+#include <thread>
+
+#include "timeline.h"
+#include "tasks.h"
+
+TaskGraph::Task TaskGraph::add(const char* name, std::function<void()> work, std::initializer_list<Task> after, Thread thread)
+{
+    Task task = nodes.size();
+    nodes.push_back(Node{name, std::move(work), thread});
+    for (Task on : after)
+        depend(task, on);
+    return task;
+}
+
+void TaskGraph::depend(Task task, Task on)
+{
+    nodes[on].next.push_back(task);
+    nodes[task].waiting++;
+}
+
+void TaskGraph::fail(int code)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed == 0)
+        failed = code;
+}
+
+int TaskGraph::run(int workers)
+{
+    remaining = nodes.size();
+    failed    = 0;
+    for (Task task = 0; task < nodes.size(); task++) {
+        if (nodes[task].waiting == 0)
+            queues[nodes[task].thread].push_back(task);
+    }
+
+    // the calling thread stays free for main tasks unless there are no workers
+    helping = workers == 0;
+
+    std::vector<std::thread> threads{};
+    for (int i = 0; i < workers; i++)
+        threads.emplace_back(&TaskGraph::drain, this, Any);
+
+    drain(Main);
+
+    for (auto& thread : threads)
+        thread.join();
+    return failed;
+}
+
+void TaskGraph::execute(Task task, bool skip)
+{
+    if (!skip) {
+        auto trace = timeline().scope(nodes[task].name);
+        nodes[task].work();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Task next : nodes[task].next) {
+        if (--nodes[next].waiting == 0)
+            queues[nodes[next].thread].push_back(next);
+    }
+    remaining--;
+    ready.notify_all();
+}
+
+void TaskGraph::drain(Thread thread)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [&]() { return remaining == 0 || !queues[thread].empty() || (thread == Main && helping && !queues[Any].empty()); });
+        if (remaining == 0)
+            return;
+
+        auto& queue = !queues[thread].empty() ? queues[thread] : queues[Any];
+        Task  task  = queue.front();
+        bool  skip  = failed != 0;
+        queue.pop_front();
+
+        lock.unlock();
+        execute(task, skip);
+        lock.lock();
+    }
+}
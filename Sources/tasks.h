@@ -0,0 +1,63 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <initializer_list>
+#include <condition_variable>
+
+// Startup work with explicit dependencies, run once on a small thread pool.
+// Main tasks run on the thread calling run(), for GLFW and OpenGL calls.
+struct TaskGraph
+{
+    using Task = size_t;
+
+    enum Thread
+    {
+        Any,
+        Main,
+    };
+
+    // `name` is a string literal, shown in the startup timeline
+    Task add(const char* name, std::function<void()> work, std::initializer_list<Task> after = {}, Thread thread = Any);
+
+    // `task` also waits for `on`, for tasks added by someone else
+    void depend(Task task, Task on);
+
+    // stop the graph from a task, tasks not started yet are skipped; `code` is not 0
+    void fail(int code);
+
+    // run all tasks with `workers` extra threads, returns when all are done or skipped,
+    // with the code of the first failure or 0
+    int run(int workers);
+
+    size_t size() const { return nodes.size(); }
+
+private:
+    struct Node
+    {
+        const char*           name = "";
+        std::function<void()> work{};
+        Thread                thread  = Any;
+        size_t                waiting = 0; // unfinished dependencies
+        std::vector<Task>     next{};      // tasks waiting for this one
+    };
+
+    // run `task` unless `skip`, then queue the tasks it unblocks
+    void execute(Task task, bool skip);
+
+    // worker loop, takes tasks of `thread` until all are done
+    void drain(Thread thread);
+
+    std::vector<Node>       nodes{};
+    std::mutex              mutex{};
+    std::condition_variable ready{};
+    std::deque<Task>        queues[2]{};
+    size_t                  remaining = 0;
+    int                     failed    = 0;     // code passed to fail()
+    bool                    helping   = false; // the main thread also runs Any tasks
+};
+
+#endif // TASKS_H
@@ -0,0 +1,77 @@
+#include <fstream>
+
+#include <Windows.h>
+
+#include "logger.h"
+#include "timeline.h"
+
+Timeline::Scope::Scope(Timeline* timeline, const char* name) : timeline(timeline), name(name)
+{
+    if (timeline)
+        begin = Clock::now();
+}
+
+Timeline::Scope::~Scope()
+{
+    if (timeline)
+        timeline->record(name, begin, Clock::now());
+}
+
+void Timeline::start(std::string path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->path = std::move(path);
+    origin     = Clock::now();
+    events.reserve(256);
+    on = true;
+}
+
+void Timeline::record(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    if (!enabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (on)
+        events.push_back(Event{name, begin, end, static_cast<uint32_t>(GetCurrentThreadId())});
+}
+
+bool Timeline::save()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!on)
+        return false;
+    on = false;
+
+    // the whole of startup, from start() to the save after the first frame
+    events.push_back(Event{"startup", origin, Clock::now(), static_cast<uint32_t>(GetCurrentThreadId())});
+
+    std::ofstream file(path, std::ios::out);
+    if (!file) {
+        Logger::error("Failed to write startup trace to {}!", path);
+        return false;
+    }
+
+    // complete ("X") events, microseconds since start()
+    auto micros = [&](Clock::time_point time) { return std::chrono::duration<double, std::micro>(time - origin).count(); };
+    auto pid    = GetCurrentProcessId();
+
+    file << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < events.size(); i++) {
+        const auto& event = events[i];
+        file << "{\"name\":\"" << event.name << "\",\"cat\":\"startup\",\"ph\":\"X\",\"ts\":" << micros(event.begin)
+             << ",\"dur\":" << micros(event.end) - micros(event.begin) << ",\"pid\":" << pid << ",\"tid\":" << event.thread << "}"
+             << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+    file << "],\"displayTimeUnit\":\"ms\"}\n";
+
+    Logger::info("Startup trace with {} events saved to {}", events.size(), path);
+    events.clear();
+    return true;
+}
+
+Timeline& timeline()
+{
+    static Timeline instance{};
+    return instance;
+}
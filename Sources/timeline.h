@@ -0,0 +1,61 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Startup phases as Chrome trace events (chrome://tracing, Perfetto).
+// Off unless started, a scope then costs one relaxed load.
+struct Timeline
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        const char*       name = ""; // string literal
+        Clock::time_point begin{};
+        Clock::time_point end{};
+        uint32_t          thread = 0;
+    };
+
+    // records the phase from construction to destruction, nested scopes nest in the viewer
+    struct Scope
+    {
+        Scope(Timeline* timeline, const char* name);
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+        Timeline*         timeline; // nullptr when disabled
+        const char*       name;
+        Clock::time_point begin;
+    };
+
+    // record from now on, `path` is written by save()
+    void start(std::string path);
+
+    Scope scope(const char* name) { return Scope(enabled() ? this : nullptr, name); }
+
+    void record(const char* name, Clock::time_point begin, Clock::time_point end);
+
+    // write the events recorded so far as trace-event JSON and stop recording
+    bool save();
+
+    bool enabled() const { return on.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool>  on{false};
+    std::mutex         mutex{};
+    std::vector<Event> events{};
+    std::string        path   = "";
+    Clock::time_point  origin = {};
+};
+
+// process-wide timeline
+Timeline& timeline();
+
+#endif // TIMELINE_H
@@ -0,0 +1,169 @@
+#include <cstring>
+#include <fstream>
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include "logger.h"
+#include "trace.h"
+
+static const char     TRACE_MAGIC[4] = {'M', 'L', 'I', 'T'};
+static const uint32_t TRACE_VERSION  = 1;
+
+static_assert(sizeof(InputTrace::Event) == 12, "trace events are stored as-is");
+
+template <typename T>
+static void write_value(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool read_value(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// ---------------------------------------------------------------------------
+
+bool InputTrace::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file) {
+        Logger::error("Failed to write input trace to {}!", path);
+        return false;
+    }
+
+    // header
+    file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    write_value(file, TRACE_VERSION);
+    write_value(file, width);
+    write_value(file, height);
+    write_value(file, static_cast<uint32_t>(frames.size()));
+
+    // frames, each followed by its events
+    for (const auto& frame : frames) {
+        write_value(file, frame.delta_time);
+        write_value(file, frame.count);
+        file.write(reinterpret_cast<const char*>(events.data() + frame.first), frame.count * sizeof(Event));
+    }
+
+    Logger::info("Input trace ({} frames, {} events) saved to {}", frames.size(), events.size(), path);
+    return true;
+}
+
+bool InputTrace::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file) {
+        Logger::error("Failed to open input trace {}!", path);
+        return false;
+    }
+
+    char     magic[4] = {};
+    uint32_t version  = 0;
+    uint32_t count    = 0;
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 || !read_value(file, version) || version != TRACE_VERSION) {
+        Logger::error("{} is not an input trace!", path);
+        return false;
+    }
+
+    if (!read_value(file, width) || !read_value(file, height) || !read_value(file, count)) {
+        Logger::error("Truncated input trace {}!", path);
+        return false;
+    }
+
+    frames.clear();
+    events.clear();
+    frames.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        Frame frame{};
+        frame.first = static_cast<uint32_t>(events.size());
+        if (!read_value(file, frame.delta_time) || !read_value(file, frame.count)) {
+            Logger::error("Truncated input trace {}!", path);
+            return false;
+        }
+
+        events.resize(events.size() + frame.count);
+        if (!file.read(reinterpret_cast<char*>(events.data() + frame.first), frame.count * sizeof(Event))) {
+            Logger::error("Truncated input trace {}!", path);
+            return false;
+        }
+        frames.push_back(frame);
+    }
+
+    Logger::info("Input trace ({} frames, {} events) loaded from {}", frames.size(), events.size(), path);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static InputTrace::Event to_trace_event(const ImGuiInputEvent& e)
+{
+    InputTrace::Event event{};
+    event.type   = static_cast<uint8_t>(e.Type);
+    event.source = static_cast<uint8_t>(e.Source);
+
+    // clang-format off
+    switch (e.Type)
+    {
+        case ImGuiInputEventType_MousePos:    event.x = e.MousePos.PosX;     event.y = e.MousePos.PosY;     break;
+        case ImGuiInputEventType_MouseWheel:  event.x = e.MouseWheel.WheelX; event.y = e.MouseWheel.WheelY; break;
+        case ImGuiInputEventType_MouseButton: event.code = static_cast<uint16_t>(e.MouseButton.Button); event.x = e.MouseButton.Down; break;
+        case ImGuiInputEventType_Key:         event.code = static_cast<uint16_t>(e.Key.Key); event.x = e.Key.Down; event.y = e.Key.AnalogValue; break;
+        case ImGuiInputEventType_Text:        event.x = static_cast<float>(e.Text.Char); break; // exact below 2^24
+        case ImGuiInputEventType_Focus:       event.x = e.AppFocused.Focused; break;
+        default:                              break;
+    }
+    // clang-format on
+
+    return event;
+}
+
+static void add_trace_event(ImGuiIO& io, const InputTrace::Event& event)
+{
+    // clang-format off
+    switch (event.type)
+    {
+        case ImGuiInputEventType_MousePos:    io.AddMousePosEvent(event.x, event.y);                                      break;
+        case ImGuiInputEventType_MouseWheel:  io.AddMouseWheelEvent(event.x, event.y);                                    break;
+        case ImGuiInputEventType_MouseButton: io.AddMouseButtonEvent(event.code, event.x != 0.0f);                        break;
+        case ImGuiInputEventType_Key:         io.AddKeyAnalogEvent(static_cast<ImGuiKey>(event.code), event.x != 0.0f, event.y); break;
+        case ImGuiInputEventType_Text:        io.AddInputCharacter(static_cast<unsigned int>(event.x));                   break;
+        case ImGuiInputEventType_Focus:       io.AddFocusEvent(event.x != 0.0f);                                          break;
+        default:                                                                                                          break;
+    }
+    // clang-format on
+}
+
+void InputTracer::before_new_frame()
+{
+    ImGuiIO& io = ImGui::GetIO();
+
+    if (mode == Record) {
+        // events left over by the last NewFrame() (trickled input) were recorded already
+        ImGuiContext& g = *ImGui::GetCurrentContext();
+
+        InputTrace::Frame record{};
+        record.delta_time = io.DeltaTime;
+        record.first      = static_cast<uint32_t>(trace.events.size());
+        for (int i = pending; i < g.InputEventsQueue.Size; i++)
+            trace.events.push_back(to_trace_event(g.InputEventsQueue[i]));
+        record.count = static_cast<uint32_t>(trace.events.size()) - record.first;
+        trace.frames.push_back(record);
+    }
+
+    if (mode == Replay && frame < trace.frames.size()) {
+        const auto& record = trace.frames[frame];
+        for (uint32_t i = 0; i < record.count; i++)
+            add_trace_event(io, trace.events[record.first + i]);
+    }
+
+    frame++;
+}
+
+void InputTracer::after_new_frame()
+{
+    if (mode == Record)
+        pending = ImGui::GetCurrentContext()->InputEventsQueue.Size;
+}
@@ -0,0 +1,65 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Per-frame ImGui input events in a compact binary form.
+struct InputTrace
+{
+    // one ImGuiInputEvent, 12 bytes on disk
+    //   mouse pos/wheel: x, y
+    //   mouse button:    code = button, x = down
+    //   key:             code = key, x = down, y = analog value
+    //   text:            x = character
+    //   focus:           x = focused
+    struct Event
+    {
+        uint8_t  type   = 0; // ImGuiInputEventType
+        uint8_t  source = 0; // ImGuiInputSource
+        uint16_t code   = 0;
+        float    x      = 0.0f;
+        float    y      = 0.0f;
+    };
+
+    // events of a frame are events[first, first + count)
+    struct Frame
+    {
+        float    delta_time = 0.0f;
+        uint32_t first      = 0;
+        uint32_t count      = 0;
+    };
+
+    bool save(const std::string& path) const;
+
+    bool load(const std::string& path);
+
+    uint32_t           width  = 0;
+    uint32_t           height = 0;
+    std::vector<Frame> frames{};
+    std::vector<Event> events{};
+};
+
+// Records the input ImGui is about to consume each frame, or replays it.
+// Hooked around ImGui::NewFrame(), after the platform queued its events.
+struct InputTracer
+{
+    enum Mode
+    {
+        Off,
+        Record,
+        Replay,
+    };
+
+    void before_new_frame();
+
+    void after_new_frame();
+
+    Mode       mode    = Off;
+    size_t     frame   = 0;
+    int        pending = 0; // events left queued by the last NewFrame()
+    InputTrace trace{};
+};
+
+#endif // TRACE_H
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "config.h"
+
+// ---------------------------------------------------------------------------
+
+TEST(Config, DefaultConfigParses)
+{
+    Config config{};
+    EXPECT_TRUE(parse_config(default_config, config));
+    EXPECT_FALSE(config.display_settings.empty());
+    EXPECT_FALSE(config.application_launchers.empty());
+}
+
+TEST(Config, LibrariesWithoutApps)
+{
+    // apps imported from a library need no [[apps]] at all
+    Config config{};
+    ASSERT_TRUE(parse_config(R"(
+[[libraries]]
+type = "steam"
+path = "C:/Program Files (x86)/Steam/steamapps"
+)", config));
+    EXPECT_TRUE(config.display_settings.empty());
+    EXPECT_TRUE(config.application_launchers.empty());
+    ASSERT_EQ(config.libraries.size(), 1u);
+    EXPECT_EQ(config.libraries[0].type, "steam");
+}
+
+TEST(Config, EmptyConfig)
+{
+    Config config{};
+    EXPECT_TRUE(parse_config("", config));
+    EXPECT_TRUE(config.display_settings.empty());
+    EXPECT_TRUE(config.application_launchers.empty());
+}
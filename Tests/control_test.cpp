@@ -0,0 +1,83 @@
+#include <string>
+#include <gtest/gtest.h>
+
+#include "control.h"
+
+// ---------------------------------------------------------------------------
+
+// answers each request with Ok and the request echoed back
+static std::string echo(std::string_view request)
+{
+    ControlWriter writer{};
+    writer.u8(static_cast<uint8_t>(ControlStatus::Ok));
+    writer.buffer.append(request);
+    return writer.buffer;
+}
+
+TEST(Control, WriterReaderRoundTrip)
+{
+    ControlWriter writer{};
+    writer.u8(7);
+    writer.u32(0xDEADBEEFu);
+    writer.u64(1ull << 40);
+    writer.i32(-1080);
+    writer.f32(1.5f);
+    writer.str("Steam Big Picture");
+
+    ControlReader reader(writer.buffer);
+    EXPECT_EQ(reader.u8(), 7u);
+    EXPECT_EQ(reader.u32(), 0xDEADBEEFu);
+    EXPECT_EQ(reader.u64(), 1ull << 40);
+    EXPECT_EQ(reader.i32(), -1080);
+    EXPECT_EQ(reader.f32(), 1.5f);
+    EXPECT_EQ(reader.str(), "Steam Big Picture");
+    EXPECT_TRUE(reader.ok);
+
+    // reads past the end yield zeros
+    EXPECT_EQ(reader.u32(), 0u);
+    EXPECT_FALSE(reader.ok);
+}
+
+TEST(Control, PipelinedResponsesComeBackInOrder)
+{
+    const std::string name = CONTROL_PIPE_NAME "-Test";
+
+    ControlServer server{};
+    ASSERT_TRUE(server.start(echo, name));
+
+    ControlClient client{};
+    ASSERT_TRUE(client.connect(name));
+
+    // 64 requests in flight before the first response is read
+    for (int32_t i = 0; i < 64; i++) {
+        ControlWriter request{};
+        request.u8(static_cast<uint8_t>(ControlCommand::Status));
+        request.i32(i);
+        ASSERT_TRUE(client.send(request.buffer));
+    }
+
+    std::string response;
+    for (int32_t i = 0; i < 64; i++) {
+        ASSERT_TRUE(client.receive(response));
+        ControlReader reader(response);
+        EXPECT_EQ(reader.u8(), static_cast<uint8_t>(ControlStatus::Ok));
+        EXPECT_EQ(reader.u8(), static_cast<uint8_t>(ControlCommand::Status));
+        EXPECT_EQ(reader.i32(), i);
+        EXPECT_TRUE(reader.ok);
+    }
+
+    client.disconnect();
+    server.stop();
+    EXPECT_EQ(server.requests.load(), 64u);
+}
+
+TEST(Control, SecondServerOnTheSamePipeFails)
+{
+    const std::string name = CONTROL_PIPE_NAME "-Test-Owner";
+
+    ControlServer first{};
+    ControlServer second{};
+    ASSERT_TRUE(first.start(echo, name));
+    EXPECT_FALSE(second.start(echo, name));
+    first.stop();
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+#include "covers.h"
+
+#include "fixtures.h"
+
+// ---------------------------------------------------------------------------
+
+struct CoverCacheTest : public testing::Test
+{
+    static constexpr int count = 64, page = 8, width = 60, height = 90;
+
+    void SetUp() override
+    {
+        folder = std::filesystem::temp_directory_path() / "moonlight-launcher-test-covers";
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directories(folder);
+        for (int i = 0; i < count; i++) {
+            paths.push_back((folder / ("cover" + std::to_string(i) + ".bmp")).string());
+            write_bmp(paths.back(), width, height, 0x102030u * (i + 1));
+        }
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(folder);
+    }
+
+    // request `path` every frame until it has a texture or failed, false on timeout
+    bool wait_for(CoverCache& covers, const std::vector<std::string>& wanted)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            covers.update(std::chrono::milliseconds(2));
+
+            size_t done = 0;
+            for (const auto& path : wanted)
+                done += covers.request(path, width, height).texture != nullptr;
+            if (done == wanted.size() || covers.failures > 0)
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    std::filesystem::path    folder{};
+    std::vector<std::string> paths{};
+    SoftwareRenderer         renderer{};
+};
+
+TEST_F(CoverCacheTest, DecodesAtTileSize)
+{
+    CoverCache covers{};
+    covers.start(&renderer, 64 * 1024 * 1024, 2, nullptr);
+
+    ASSERT_TRUE(wait_for(covers, {paths[0]}));
+    EXPECT_EQ(covers.failures.load(), 0u);
+
+    Cover cover = covers.request(paths[0], width, height);
+    EXPECT_NE(cover.texture, nullptr);
+    EXPECT_EQ(cover.width, width);
+    EXPECT_EQ(cover.height, height);
+    EXPECT_EQ(covers.textures(), 1u);
+    covers.stop();
+    EXPECT_EQ(covers.textures(), 0u);
+}
+
+TEST_F(CoverCacheTest, ScrollingStaysWithinBudget)
+{
+    // room for two pages, the rest is evicted as the grid scrolls
+    const size_t page_bytes = size_t(page) * width * height * sizeof(uint32_t);
+    const size_t budget     = page_bytes * 2;
+
+    CoverCache covers{};
+    covers.start(&renderer, budget, 2, nullptr);
+
+    for (int first = 0; first < count * 2; first += page) {
+        std::vector<std::string> wanted{};
+        for (int i = first; i < first + page; i++)
+            wanted.push_back(paths[i % count]);
+
+        ASSERT_TRUE(wait_for(covers, wanted)) << "page at " << first;
+        ASSERT_EQ(covers.failures.load(), 0u);
+
+        // only the page shown last frame may stay over budget
+        EXPECT_LE(covers.resident(), budget + page_bytes) << "page at " << first;
+    }
+    EXPECT_GT(covers.evictions.load(), 0u);
+    covers.stop();
+}
+
+TEST_F(CoverCacheTest, BrokenImageFails)
+{
+    auto broken = (folder / "broken.png").string();
+    std::ofstream(broken) << "not an image";
+
+    CoverCache covers{};
+    covers.start(&renderer, 64 * 1024 * 1024, 1, nullptr);
+
+    ASSERT_TRUE(wait_for(covers, {broken}));
+    EXPECT_EQ(covers.failures.load(), 1u);
+    EXPECT_EQ(covers.request(broken, width, height).texture, nullptr);
+    covers.stop();
+}
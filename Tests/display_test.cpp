@@ -0,0 +1,68 @@
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+
+#include "display.h"
+
+using namespace std::chrono_literals;
+
+// ---------------------------------------------------------------------------
+
+// notifications are fed by hand, the listener thread only has to exist
+struct DisplayTopologyTest : public testing::Test
+{
+    void SetUp() override { topology.watch(); }
+
+    void TearDown() override { topology.stop(); }
+
+    DisplayTopology topology{};
+};
+
+TEST_F(DisplayTopologyTest, NothingExpected)
+{
+    EXPECT_TRUE(topology.settle(50ms, 200ms));
+}
+
+TEST_F(DisplayTopologyTest, SettlesAfterTheLastNotification)
+{
+    topology.expect();
+    std::thread changes([this]() {
+        for (int i = 0; i < 3; i++) {
+            std::this_thread::sleep_for(10ms);
+            topology.notify();
+        }
+    });
+
+    EXPECT_TRUE(topology.settle(50ms, 1000ms));
+    changes.join();
+}
+
+TEST_F(DisplayTopologyTest, SettledLongBeforeSettleIsCalled)
+{
+    // the user picks a mode and browses apps for longer than the timeout before launching
+    topology.expect();
+    topology.notify();
+    std::this_thread::sleep_for(300ms);
+
+    EXPECT_TRUE(topology.settle(50ms, 200ms));
+}
+
+TEST_F(DisplayTopologyTest, NoNotificationTimesOut)
+{
+    topology.expect();
+    EXPECT_FALSE(topology.settle(50ms, 100ms));
+}
+
+TEST_F(DisplayTopologyTest, StillChangingAtTheDeadline)
+{
+    topology.expect();
+    std::thread changes([this]() {
+        for (int i = 0; i < 20; i++) {
+            std::this_thread::sleep_for(10ms);
+            topology.notify();
+        }
+    });
+
+    EXPECT_FALSE(topology.settle(50ms, 100ms));
+    changes.join();
+}
@@ -0,0 +1,74 @@
+#include <string>
+#include <gtest/gtest.h>
+
+#include "fit.h"
+
+#include "fixtures.h"
+
+// ---------------------------------------------------------------------------
+
+TEST(ModeFit, RealWorldModeLists)
+{
+    for (const auto& c : fit_cases) {
+        ModeFitter fitter{};
+        fitter.reset(*c.modes);
+
+        const DisplaySettings* best = fitter.best(c.width, c.height, c.fps);
+        ASSERT_NE(best, nullptr) << c.width << "x" << c.height;
+        EXPECT_EQ(best->width, c.expect_width) << c.width << "x" << c.height;
+        EXPECT_EQ(best->height, c.expect_height) << c.width << "x" << c.height;
+    }
+}
+
+TEST(ModeFit, CachedPicksMatchUncached)
+{
+    ModeFitter cached{};
+    cached.reset(monitor_4k_144hz);
+    cached.precompute();
+
+    for (const auto& c : fit_cases) {
+        if (c.modes != &monitor_4k_144hz)
+            continue;
+
+        ModeFitter fresh{};
+        fresh.reset(monitor_4k_144hz);
+        const DisplaySettings* expected = fresh.best(c.width, c.height, c.fps);
+
+        // asked twice, the second pick comes from the cache
+        for (int i = 0; i < 2; i++) {
+            const DisplaySettings* best = cached.best(c.width, c.height, c.fps);
+            ASSERT_NE(best, nullptr);
+            EXPECT_EQ(best->width, expected->width);
+            EXPECT_EQ(best->height, expected->height);
+        }
+    }
+}
+
+TEST(ModeFit, ResetDropsCachedPicks)
+{
+    ModeFitter fitter{};
+    fitter.reset(monitor_4k_144hz);
+    ASSERT_NE(fitter.best(1280, 800), nullptr);
+
+    fitter.reset(laptop_1600p_165hz);
+    const DisplaySettings* best = fitter.best(1280, 800);
+    ASSERT_NE(best, nullptr);
+    EXPECT_EQ(best->width, 1280);
+    EXPECT_EQ(best->height, 800);
+}
+
+TEST(ModeFit, NoModes)
+{
+    ModeFitter fitter{};
+    fitter.reset({});
+    EXPECT_EQ(fitter.best(1920, 1080), nullptr);
+}
+
+TEST(ModeFit, ScoresPreferExactModes)
+{
+    const DisplaySettings exact{"", 1920, 1080, 60, 1.0f};
+    const DisplaySettings wider{"", 2560, 1080, 60, 1.0f};
+    const DisplaySettings slower{"", 1920, 1080, 30, 1.0f};
+    EXPECT_LT(score_display_mode(exact, 1920, 1080, 60), score_display_mode(wider, 1920, 1080, 60));
+    EXPECT_LT(score_display_mode(exact, 1920, 1080, 60), score_display_mode(slower, 1920, 1080, 60));
+}
@@ -0,0 +1,86 @@
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <filesystem>
+
+#include "display.h"
+
+// Inputs shared by the tests and the benchmarks.
+
+// modes as EnumDisplaySettings reports them, one per resolution/refresh/bit depth
+inline std::vector<DisplaySettings> make_modes(int resolutions)
+{
+    static const int frequencies[] = {24, 30, 50, 59, 60, 75, 120, 144};
+
+    std::vector<DisplaySettings> modes{};
+    for (int i = 0; i < resolutions; i++) {
+        for (int frequency : frequencies) {
+            for (int depth = 0; depth < 2; depth++) {
+                modes.push_back(DisplaySettings{"", 640 + i * 32, 480 + i * 18, frequency, 1.0f});
+            }
+        }
+    }
+    return modes;
+}
+
+// real-world mode lists as reported by EnumDisplaySettings, merged per resolution
+// clang-format off
+inline const std::vector<DisplaySettings> monitor_4k_144hz = {
+    {"", 3840, 2160, 144, 1.0f}, {"", 2560, 1440, 144, 1.0f}, {"", 1920, 1080, 144, 1.0f}, {"", 1680, 1050, 144, 1.0f},
+    {"", 1600,  900, 144, 1.0f}, {"", 1280, 1024, 144, 1.0f}, {"", 1280,  720, 144, 1.0f}, {"", 1024,  768, 144, 1.0f},
+    {"",  800,  600, 144, 1.0f},
+};
+inline const std::vector<DisplaySettings> laptop_1600p_165hz = {
+    {"", 2560, 1600, 165, 1.0f}, {"", 1920, 1200, 165, 1.0f}, {"", 1920, 1080, 165, 1.0f}, {"", 1680, 1050, 165, 1.0f},
+    {"", 1600,  900, 165, 1.0f}, {"", 1440,  900, 165, 1.0f}, {"", 1366,  768, 165, 1.0f}, {"", 1280,  800, 165, 1.0f},
+    {"", 1280,  720, 165, 1.0f},
+};
+inline const std::vector<DisplaySettings> tv_4k_120hz = {
+    {"", 4096, 2160, 60, 1.0f}, {"", 3840, 2160, 120, 1.0f}, {"", 2560, 1440, 120, 1.0f}, {"", 1920, 1080, 120, 1.0f},
+    {"", 1280,  720,  60, 1.0f}, {"",  720,  480,  60, 1.0f},
+};
+
+// client extent and the mode it should land on
+struct FitCase { const std::vector<DisplaySettings>* modes; int width, height, fps, expect_width, expect_height; };
+inline const FitCase fit_cases[] = {
+    {&monitor_4k_144hz,   2532, 1170,  60, 2560, 1440}, // phone, 19.5:9
+    {&monitor_4k_144hz,   1920, 1200,  60, 1680, 1050}, // 16:10 laptop
+    {&monitor_4k_144hz,   1280,  800,  60, 1680, 1050}, // handheld, aspect beats size
+    {&laptop_1600p_165hz, 1280,  800,  60, 1280,  800},
+    {&laptop_1600p_165hz, 3840, 2160,  60, 2560, 1600}, // never upscale past the panel
+    {&tv_4k_120hz,        1920, 1080, 120, 1920, 1080},
+    {&tv_4k_120hz,        2560, 1600,  60, 2560, 1440},
+};
+// clang-format on
+
+// 24-bit BMP of one color, decoded by WIC like any cover
+inline void write_bmp(const std::filesystem::path& path, int width, int height, uint32_t color)
+{
+    int      stride = (width * 3 + 3) & ~3;
+    uint32_t size   = 54 + stride * height;
+
+    std::string data(size, '\0');
+    auto        put = [&](size_t offset, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            data[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    };
+    put(0, 'B' | ('M' << 8), 2);
+    put(2, size, 4);
+    put(10, 54, 4);
+    put(14, 40, 4);
+    put(18, width, 4);
+    put(22, height, 4);
+    put(26, 1, 2);
+    put(28, 24, 2);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++)
+            put(54 + y * stride + x * 3, color, 3);
+    }
+    std::ofstream(path, std::ios::binary) << data;
+}
+
+#endif // FIXTURES_H
@@ -0,0 +1,51 @@
+#include <memory>
+#include <gtest/gtest.h>
+
+#include "config.h"
+#include "myapp.h"
+
+#include "fixtures.h"
+
+// ---------------------------------------------------------------------------
+
+// every tab, rasterized or skipped as unchanged, allocates nothing once warmed up
+struct FrameTest : public testing::TestWithParam<std::tuple<int, bool>>
+{
+};
+
+TEST_P(FrameTest, SteadyStateDoesNotAllocate)
+{
+    MyApp app;
+    app.width          = 1280;
+    app.height         = 720;
+    app.tab_index      = std::get<0>(GetParam());
+    app.platform       = std::make_unique<NullPlatform>(0);
+    app.renderer       = std::make_unique<SoftwareRenderer>();
+    app.redraw.enabled = !std::get<1>(GetParam());
+    app.logs           = std::make_shared<RingBufferSink>(512);
+
+    Config config{};
+    ASSERT_TRUE(parse_config(default_config, config));
+    app.preset_display_settings = config.display_settings;
+    app.application_launchers   = config.application_launchers;
+    for (const auto& mode : make_modes(32))
+        merge_display_settings(app.supported_display_settings, mode);
+
+    app.setup();
+
+    // first frames size ImGui's buffers and the arena
+    for (int i = 0; i < 8; i++)
+        app.frame();
+
+    AllocationStats allocations{};
+    for (int i = 0; i < 32; i++) {
+        app.frame();
+        allocations.count += app.frame_allocations.count;
+        allocations.bytes += app.frame_allocations.bytes;
+    }
+    app.cleanup();
+
+    EXPECT_EQ(allocations.count, 0u) << allocations.bytes << " bytes allocated in steady state";
+}
+
+INSTANTIATE_TEST_SUITE_P(Tabs, FrameTest, testing::Combine(testing::Values(0, 1, 2, 3, 4), testing::Bool()));
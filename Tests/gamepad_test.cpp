@@ -0,0 +1,132 @@
+#include <cmath>
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "gamepad.h"
+
+// ---------------------------------------------------------------------------
+
+using Axes = std::array<float, GAMEPAD_AXIS_COUNT>;
+
+// one GLFW gamepad state: left x/y, right x/y, left/right trigger, and the axis keys it should press
+struct AxisSample
+{
+    Axes                  axes;
+    std::vector<ImGuiKey> pressed;
+};
+
+// clang-format off
+// recorded from an Xbox One pad (worn left stick) and a DualShock 4, sticks rest near 0, triggers at -1
+static const AxisSample xbox_trace[] = {
+    {{ 0.0471f, -0.0392f, -0.0627f,  0.0314f, -1.0000f, -1.0000f }, {}},                                                   // at rest
+    {{ 0.2118f,  0.1059f, -0.0627f,  0.0314f, -1.0000f, -1.0000f }, {}},                                                   // worn stick drift
+    {{ 0.6000f,  0.0500f, -0.0627f,  0.0314f, -1.0000f, -1.0000f }, {ImGuiKey_GamepadLStickRight}},                        // push right, slightly down
+    {{ 0.9843f,  0.0824f, -0.0627f,  0.0314f, -1.0000f, -1.0000f }, {ImGuiKey_GamepadLStickRight}},                        // full right
+    {{ 0.4510f,  0.1059f, -0.0627f,  0.0314f, -1.0000f, -1.0000f }, {ImGuiKey_GamepadLStickRight}},                        // released
+    {{ 0.0471f, -0.0392f, -0.0627f,  0.0314f, -1.0000f, -0.7804f }, {}},                                                   // trigger touched
+    {{ 0.0471f, -0.0392f, -0.0627f,  0.0314f, -1.0000f,  0.0000f }, {ImGuiKey_GamepadR2}},                                 // half pull
+    {{ 0.0471f, -0.0392f, -0.0627f,  0.0314f, -1.0000f,  1.0000f }, {ImGuiKey_GamepadR2}},                                 // full pull
+    {{ 0.0471f, -0.0392f, -0.0627f,  0.0314f, -1.0000f, -1.0000f }, {}},                                                   // at rest
+};
+
+static const AxisSample dualshock_trace[] = {
+    {{ 0.0078f,  0.0157f,  0.0078f, -0.0039f, -1.0000f, -1.0000f }, {}},                                                   // at rest
+    {{-0.7071f, -0.7071f,  0.0078f, -0.0039f, -1.0000f, -1.0000f }, {ImGuiKey_GamepadLStickLeft, ImGuiKey_GamepadLStickUp}}, // diagonal up-left
+    {{ 0.0078f,  0.0157f,  0.0078f,  0.3000f, -1.0000f, -1.0000f }, {}},                                                   // just past the deadzone, below the threshold
+    {{ 0.0078f,  0.0157f,  0.0078f,  0.9000f, -0.9000f, -1.0000f }, {ImGuiKey_GamepadRStickDown}},                         // right stick down
+    {{ 0.0078f,  0.0157f,  0.0078f, -0.0039f,  0.2000f, -1.0000f }, {ImGuiKey_GamepadL2}},                                 // left trigger
+};
+// clang-format on
+
+// axis keys pressed by one sample, in default_gamepad_axes order
+static std::vector<ImGuiKey> pressed_keys(const GamepadProfile& profile, const Axes& axes)
+{
+    const auto values = apply_gamepad_profile(profile, axes.data());
+
+    std::vector<ImGuiKey> keys{};
+    for (const auto& mapping : default_gamepad_axes) {
+        if (gamepad_axis_value(values, mapping) > profile.threshold)
+            keys.push_back(mapping.key);
+    }
+    return keys;
+}
+
+template <size_t N>
+static void replay(const GamepadProfile& profile, const AxisSample (&trace)[N])
+{
+    for (size_t i = 0; i < N; i++) {
+        EXPECT_EQ(pressed_keys(profile, trace[i].axes), trace[i].pressed) << "sample " << i;
+
+        for (float value : apply_gamepad_profile(profile, trace[i].axes.data())) {
+            EXPECT_GE(value, -1.0f) << "sample " << i;
+            EXPECT_LE(value, 1.0f) << "sample " << i;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(Gamepad, ReplaysRecordedTraces)
+{
+    GamepadProfile profile{};
+    replay(profile, xbox_trace);
+    replay(profile, dualshock_trace);
+}
+
+TEST(Gamepad, RestingAxesAreZero)
+{
+    const auto values = apply_gamepad_profile(GamepadProfile{}, xbox_trace[0].axes.data());
+    for (float value : values)
+        EXPECT_EQ(value, 0.0f);
+}
+
+TEST(Gamepad, RadialDeadzoneKeepsDirection)
+{
+    // a full diagonal is shaped as a unit vector, not clamped per axis
+    const auto values = apply_gamepad_profile(GamepadProfile{}, dualshock_trace[1].axes.data());
+    EXPECT_NEAR(values[GLFW_GAMEPAD_AXIS_LEFT_X], -0.7071f, 1e-3f);
+    EXPECT_NEAR(values[GLFW_GAMEPAD_AXIS_LEFT_Y], -0.7071f, 1e-3f);
+}
+
+TEST(Gamepad, ProfileOverridesByGuid)
+{
+    GamepadProfiles profiles{};
+    profiles.overrides["030000004c050000cc09000011810000"].stick_deadzone = 0.10f;
+
+    // the smaller deadzone turns the sample below the threshold into a press
+    const auto& profile = profiles.find("030000004c050000cc09000011810000");
+    EXPECT_EQ(pressed_keys(profile, dualshock_trace[2].axes), std::vector<ImGuiKey>{ImGuiKey_GamepadRStickDown});
+
+    // unknown and missing GUIDs use the default profile
+    EXPECT_EQ(&profiles.find("03000000de280000ff11000001000000"), &profiles.fallback);
+    EXPECT_EQ(&profiles.find(nullptr), &profiles.fallback);
+    replay(profiles.find(nullptr), xbox_trace);
+}
+
+TEST(Gamepad, ResponseCurve)
+{
+    GamepadProfile profile{};
+    profile.response = 2.0f;
+
+    // ((|v| - 0.25) / 0.75)^2 along the stick direction
+    const auto& axes     = xbox_trace[2].axes;
+    const float length   = std::hypot(axes[0], axes[1]);
+    const float expected = std::pow((length - 0.25f) / 0.75f, 2.0f) * axes[0] / length;
+    const auto  values   = apply_gamepad_profile(profile, axes.data());
+    EXPECT_NEAR(values[GLFW_GAMEPAD_AXIS_LEFT_X], expected, 1e-5f);
+}
+
+TEST(Gamepad, RemapButton)
+{
+    GamepadProfile profile{};
+    EXPECT_TRUE(remap_gamepad_button(profile, "face_down", GLFW_GAMEPAD_BUTTON_B));
+    EXPECT_FALSE(remap_gamepad_button(profile, "face_down", GLFW_GAMEPAD_BUTTON_LAST + 1));
+    EXPECT_FALSE(remap_gamepad_button(profile, "unknown", GLFW_GAMEPAD_BUTTON_A));
+
+    for (const auto& mapping : profile.buttons) {
+        if (mapping.key == ImGuiKey_GamepadFaceDown) {
+            EXPECT_EQ(mapping.button, GLFW_GAMEPAD_BUTTON_B);
+        }
+    }
+}
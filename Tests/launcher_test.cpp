@@ -0,0 +1,101 @@
+#include <fstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+#include "launcher.h"
+
+// ---------------------------------------------------------------------------
+
+TEST(Launcher, EffectiveAffinity)
+{
+    ProcessOptions options{};
+    EXPECT_EQ(effective_affinity(options, 0xFF), 0xFFu);
+
+    // reserved cores are taken out of the default (all cores) and of an explicit mask
+    options.reserved = 0x03;
+    EXPECT_EQ(effective_affinity(options, 0xFF), 0xFCu);
+    options.affinity = 0x0F;
+    EXPECT_EQ(effective_affinity(options, 0xFF), 0x0Cu);
+
+    // cores the system does not have are dropped, nothing left is 0
+    options.affinity = 0x300;
+    EXPECT_EQ(effective_affinity(options, 0xFF), 0u);
+    options.affinity = 0;
+    options.reserved = 0xFF;
+    EXPECT_EQ(effective_affinity(options, 0xFF), 0u);
+}
+
+TEST(Launcher, PriorityNames)
+{
+    ProcessOptions options{};
+    EXPECT_TRUE(set_priority_class(options, "below_normal"));
+    EXPECT_EQ(options.priority_class, static_cast<DWORD>(BELOW_NORMAL_PRIORITY_CLASS));
+    EXPECT_FALSE(set_priority_class(options, "realtime"));
+    EXPECT_EQ(options.priority_class, static_cast<DWORD>(BELOW_NORMAL_PRIORITY_CLASS));
+
+    EXPECT_TRUE(set_io_priority(options, "very_low"));
+    EXPECT_EQ(options.io_priority, 0);
+    EXPECT_FALSE(set_io_priority(options, "critical"));
+    EXPECT_FALSE(options.empty());
+}
+
+TEST(Launcher, ScriptName)
+{
+    EXPECT_EQ(script_name("Steam Big Picture"), "Steam_Big_Picture.bat");
+    EXPECT_EQ(script_name("Half-Life 2: Episode <One>"), "Half-Life_2__Episode__One_.bat");
+}
+
+// ---------------------------------------------------------------------------
+
+struct SpawnTest : public testing::Test
+{
+    void SetUp() override
+    {
+        script = std::filesystem::temp_directory_path() / "moonlight-launcher-test.bat";
+        std::ofstream(script) << "@ping -n 5 127.0.0.1 >nul\n";
+        GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(script);
+    }
+
+    std::filesystem::path script{};
+    DWORD_PTR             process_mask = 0;
+    DWORD_PTR             system_mask  = 0;
+};
+
+TEST_F(SpawnTest, ChildGetsTheOptions)
+{
+    // lowest core, the next one reserved
+    ProcessOptions options{};
+    options.affinity       = system_mask & (~system_mask + 1);
+    options.reserved       = (system_mask & ~options.affinity) & (~(system_mask & ~options.affinity) + 1);
+    options.affinity      |= options.reserved;
+    options.priority_class = BELOW_NORMAL_PRIORITY_CLASS;
+    options.io_priority    = 1;
+
+    HANDLE process = spawn_process(script.string(), false, options);
+    ASSERT_NE(process, nullptr);
+
+    DWORD_PTR child_mask = 0, child_system = 0;
+    GetProcessAffinityMask(process, &child_mask, &child_system);
+    DWORD priority_class = GetPriorityClass(process);
+
+    TerminateProcess(process, 0);
+    WaitForSingleObject(process, INFINITE);
+    CloseHandle(process);
+
+    EXPECT_EQ(static_cast<uint64_t>(child_mask), effective_affinity(options, system_mask));
+    EXPECT_EQ(priority_class, options.priority_class);
+}
+
+TEST_F(SpawnTest, NoCoresLeftDoesNotStart)
+{
+    // every core reserved, the app must not run with the default affinity instead
+    ProcessOptions options{};
+    options.reserved = system_mask;
+
+    EXPECT_EQ(spawn_process(script.string(), false, options), nullptr);
+}
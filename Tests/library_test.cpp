@@ -0,0 +1,92 @@
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+#include "library.h"
+
+// ---------------------------------------------------------------------------
+
+static void write_manifest(const std::filesystem::path& steamapps, int appid, const std::string& name)
+{
+    std::ofstream(steamapps / ("appmanifest_" + std::to_string(appid) + ".acf"))
+        << "\"AppState\"\n{\n\t\"appid\"\t\t\"" << appid << "\"\n\t\"Universe\"\t\t\"1\"\n"
+        << "\t\"name\"\t\t\"" << name << "\"\n\t\"StateFlags\"\t\t\"4\"\n}\n";
+}
+
+struct LibraryTest : public testing::Test
+{
+    void SetUp() override
+    {
+        steamapps = std::filesystem::temp_directory_path() / "moonlight-launcher-test-steamapps";
+        std::filesystem::remove_all(steamapps);
+        std::filesystem::create_directories(steamapps);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(steamapps);
+    }
+
+    std::filesystem::path steamapps{};
+};
+
+TEST(Library, ParseAppManifest)
+{
+    std::string appid, name;
+    EXPECT_TRUE(parse_app_manifest("\"AppState\"\n{\n\t\"appid\"\t\t\"1245620\"\n\t\"name\"\t\t\"ELDEN RING\"\n}\n", appid, name));
+    EXPECT_EQ(appid, "1245620");
+    EXPECT_EQ(name, "ELDEN RING");
+
+    EXPECT_FALSE(parse_app_manifest("\"AppState\"\n{\n\t\"appid\"\t\t\"1245620\"\n}\n", appid, name));
+}
+
+TEST(Library, ParseLibraryFolders)
+{
+    const char* vdf = "\"libraryfolders\"\n{\n"
+                      "\t\"0\"\n\t{\n\t\t\"path\"\t\t\"C:\\\\Program Files (x86)\\\\Steam\"\n\t}\n"
+                      "\t\"1\"\n\t{\n\t\t\"path\"\t\t\"D:\\\\SteamLibrary\"\n\t}\n}\n";
+    auto folders = parse_library_folders(vdf);
+    ASSERT_EQ(folders.size(), 2u);
+    EXPECT_EQ(folders[1], "D:\\SteamLibrary");
+}
+
+TEST_F(LibraryTest, ScansInstalledGames)
+{
+    for (int i = 0; i < 256; i++)
+        write_manifest(steamapps, 1000 + i, "Game " + std::to_string(i));
+    write_manifest(steamapps, 228980, "Steamworks Common Redistributables");
+    std::ofstream(steamapps / "libraryfolders.vdf") << "\"libraryfolders\"\n{\n}\n";
+
+    LibraryDirectory directory = scan_library_directory("steam", steamapps.string(), {});
+    ASSERT_EQ(directory.entries.size(), 256u);
+    EXPECT_EQ(directory.entries.front().name, "Game 0");
+    EXPECT_EQ(directory.entries.front().commands, "start \"\" \"steam://rungameid/1000\"\n");
+    EXPECT_TRUE(std::is_sorted(directory.entries.begin(), directory.entries.end(),
+        [](const LibraryDirectory::Entry& a, const LibraryDirectory::Entry& b) { return a.name < b.name; }));
+}
+
+TEST_F(LibraryTest, UnchangedDirectoryComesFromTheCache)
+{
+    write_manifest(steamapps, 1000, "Game");
+
+    // a cached scan of the same mtime is returned as-is, without reading the manifests
+    LibraryDirectory cached = scan_library_directory("steam", steamapps.string(), {});
+    ASSERT_EQ(cached.entries.size(), 1u);
+    cached.entries.front().name = "From cache";
+
+    LibraryDirectory directory = scan_library_directory("steam", steamapps.string(), {cached});
+    ASSERT_EQ(directory.entries.size(), 1u);
+    EXPECT_EQ(directory.entries.front().name, "From cache");
+
+    // another type of the same path is scanned again
+    EXPECT_TRUE(scan_library_directory("folder", steamapps.string(), {cached}).entries.empty());
+}
+
+TEST_F(LibraryTest, MissingDirectory)
+{
+    LibraryDirectory directory = scan_library_directory("steam", (steamapps / "missing").string(), {});
+    EXPECT_TRUE(directory.entries.empty());
+    EXPECT_EQ(directory.mtime, 0);
+}
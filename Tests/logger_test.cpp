@@ -0,0 +1,41 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "logger.h"
+
+// ---------------------------------------------------------------------------
+
+TEST(RingBufferSink, KeepsNewestOldestFirst)
+{
+    auto sink   = std::make_shared<RingBufferSink>(3);
+    auto logger = std::make_shared<spdlog::logger>("ring", sink);
+    for (int i = 0; i < 5; i++)
+        logger->info("message {}", i);
+
+    EXPECT_EQ(sink->logs(), (std::vector<std::string>{"message 2", "message 3", "message 4"}));
+}
+
+TEST(RingBufferSink, ConcurrentWritersAndReader)
+{
+    auto sink   = std::make_shared<RingBufferSink>(64);
+    auto logger = std::make_shared<spdlog::logger>("ring", sink);
+
+    // writers wrap the buffer many times while the reader visits it, as the logs tab does
+    std::vector<std::thread> writers{};
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&logger, t]() {
+            for (int i = 0; i < 2000; i++)
+                logger->info("thread {} message {}", t, i);
+        });
+    }
+
+    size_t visited = 0;
+    for (int i = 0; i < 200; i++)
+        sink->visit([&](const std::string& message) { visited += message.empty() ? 0 : 1; });
+
+    for (auto& writer : writers)
+        writer.join();
+    EXPECT_GT(visited, 0u);
+    EXPECT_EQ(sink->logs().size(), 64u);
+}
@@ -0,0 +1,14 @@
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include "path.h"
+#include "logger.h"
+
+int main(int argc, char** argv)
+{
+    // code under test logs, keep it out of the test output
+    Logger::set_logger(std::make_shared<spdlog::logger>(APP_NAME, std::make_shared<spdlog::sinks::null_sink_mt>()));
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,54 @@
+#include <string>
+#include <gtest/gtest.h>
+
+#include "metrics.h"
+
+// ---------------------------------------------------------------------------
+
+TEST(Metrics, RegistrationReturnsTheSameMetric)
+{
+    Metrics registry{};
+    Counter& a = registry.counter("test_requests", "Requests");
+    Counter& b = registry.counter("test_requests", "Requests");
+    EXPECT_EQ(&a, &b);
+
+    a.add(3);
+    EXPECT_EQ(b.get(), 3u);
+}
+
+TEST(Metrics, HistogramBucketsAreCumulative)
+{
+    Histogram histogram{0.001, 0.01, 0.1, 1.0};
+    for (int i = 0; i < 1000; i++)
+        histogram.observe(i / 1000.0);
+
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.bucket(histogram.size), histogram.count());
+    for (size_t i = 1; i <= histogram.size; i++)
+        EXPECT_GE(histogram.bucket(i), histogram.bucket(i - 1));
+
+    // 0.000 and 0.001 are <= 0.001, 0.002 .. 0.010 add 9 more
+    EXPECT_EQ(histogram.bucket(0), 2u);
+    EXPECT_EQ(histogram.bucket(1), 11u);
+    EXPECT_DOUBLE_EQ(histogram.estimate(0.5), 1.0);
+    EXPECT_NEAR(histogram.sum(), 499.5, 1e-6);
+}
+
+TEST(Metrics, TextExposition)
+{
+    Metrics registry{};
+    registry.counter("test_launches", "Launches").add(2);
+    registry.gauge("test_textures", "Textures").set(-1);
+    registry.histogram("test_seconds", "Seconds", {0.5, 1.0}).observe(0.75);
+
+    std::string text = registry.text();
+    EXPECT_NE(text.find("# TYPE test_launches_total counter\ntest_launches_total 2\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_textures gauge\ntest_textures -1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_seconds_bucket{le=\"0.5\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("test_seconds_bucket{le=\"1\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_seconds_bucket{le=\"+Inf\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_seconds_count 1\n"), std::string::npos);
+
+    ASSERT_GE(text.size(), 6u);
+    EXPECT_EQ(text.compare(text.size() - 6, 6, "# EOF\n"), 0);
+}
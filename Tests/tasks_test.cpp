@@ -0,0 +1,49 @@
+#include <atomic>
+#include <gtest/gtest.h>
+
+#include "tasks.h"
+
+// ---------------------------------------------------------------------------
+
+TEST(TaskGraph, RunsEveryTaskAfterItsDependencies)
+{
+    TaskGraph        graph{};
+    std::atomic<int> order{0};
+    int              first = -1, second = -1, last = -1;
+
+    auto a = graph.add("a", [&]() { first = order++; });
+    auto b = graph.add("b", [&]() { second = order++; }, {a});
+    graph.add("c", [&]() { last = order++; }, {a, b}, TaskGraph::Main);
+
+    EXPECT_EQ(graph.run(2), 0);
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(second, 1);
+    EXPECT_EQ(last, 2);
+}
+
+TEST(TaskGraph, FailureSkipsTheRestAndIsReturned)
+{
+    TaskGraph        graph{};
+    std::atomic<int> ran{0};
+
+    auto window = graph.add("window", [&]() { graph.fail(1); }, {}, TaskGraph::Main);
+    auto render = graph.add("renderer", [&]() { ran++; }, {window}, TaskGraph::Main);
+    graph.add("fonts", [&]() { ran++; }, {render});
+
+    // a second failure keeps the first code
+    graph.add("late", [&]() { graph.fail(-1); }, {render});
+
+    EXPECT_EQ(graph.run(2), 1);
+    EXPECT_EQ(ran, 0);
+}
+
+TEST(TaskGraph, RunsWithoutWorkers)
+{
+    TaskGraph graph{};
+    int       ran = 0;
+    graph.add("any", [&]() { ran++; });
+    graph.add("main", [&]() { ran++; }, {}, TaskGraph::Main);
+
+    EXPECT_EQ(graph.run(0), 0);
+    EXPECT_EQ(ran, 2);
+}